@@ -0,0 +1,196 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  BulkInsert
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+
+using EseObjects;
+using EseLinq.Storage;
+
+namespace EseLinq
+{
+	/// <summary>
+	/// Controls how BulkInsert splits the load into transactions.
+	/// </summary>
+	public class BulkInsertOptions
+	{
+		/// <summary>
+		/// Rows inserted per transaction. Each full batch is committed with lazy flush.
+		/// </summary>
+		public int BatchSize = 1000;
+
+		/// <summary>
+		/// Rows inserted between checks of Session.IsVersionStoreHalfFull, which commits the batch early when set. Zero disables the check.
+		/// </summary>
+		public int VersionStoreCheckInterval = 100;
+
+		/// <summary>
+		/// Called after each batch is committed with the totals so far.
+		/// </summary>
+		public Action<BulkInsertProgress> Progress;
+	}
+
+	/// <summary>
+	/// Totals of a BulkInsert, so far or when finished.
+	/// </summary>
+	public class BulkInsertProgress
+	{
+		/// <summary>Rows inserted and committed.</summary>
+		public long Rows;
+		/// <summary>Transactions committed.</summary>
+		public int Batches;
+		/// <summary>Time spent since the insert started.</summary>
+		public TimeSpan Elapsed;
+
+		/// <summary>Average rows inserted per second.</summary>
+		public double RowsPerSecond
+		{
+			get
+			{
+				return Elapsed.Ticks > 0 ? Rows / Elapsed.TotalSeconds : 0;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Provides extension methods to EseObjects for loading many rows at once.
+	/// </summary>
+	public static class BulkInsertExt
+	{
+		/// <summary>
+		/// Inserts all rows into a table using a default row bridge and default options.
+		/// </summary>
+		public static BulkInsertProgress BulkInsert<T>(this Table table, IEnumerable<T> rows)
+		{
+			return table.BulkInsert(rows, new Flat<T>(table), new BulkInsertOptions());
+		}
+
+		/// <summary>
+		/// Inserts all rows into a table using the specified row bridge and default options.
+		/// </summary>
+		public static BulkInsertProgress BulkInsert<T>(this Table table, IEnumerable<T> rows, IRecordBridge<T> bridge)
+		{
+			return table.BulkInsert(rows, bridge, new BulkInsertOptions());
+		}
+
+		/// <summary>
+		/// Inserts all rows into a table, splitting the work into transactions so the version store isn't exhausted.
+		/// </summary>
+		/// <remarks>
+		/// A transaction is committed with lazy flush every options.BatchSize rows, or earlier if the version store is half full.
+		/// The last transaction is committed normally, which also flushes the lazy commits before it.
+		/// If an exception is thrown, only the batch in progress is rolled back; rows from committed batches remain.
+		/// If the table's session is already in a transaction, each batch is a nested level of it: nothing is durable until the caller's transaction commits,
+		/// and the version store is only relieved then, so call this outside of a transaction for large loads.
+		/// </remarks>
+		/// <typeparam name="T">Type of the rows to insert.</typeparam>
+		/// <param name="table">Destination table.</param>
+		/// <param name="rows">Rows to insert.</param>
+		/// <param name="bridge">Bridge used to write each row.</param>
+		/// <param name="options">Batching options.</param>
+		/// <returns>Totals of the insert, including rows per second.</returns>
+		public static BulkInsertProgress BulkInsert<T>(this Table table, IEnumerable<T> rows, IRecordBridge<T> bridge, BulkInsertOptions options)
+		{
+			if(table == null)
+				throw new ArgumentNullException("table");
+			if(rows == null)
+				throw new ArgumentNullException("rows");
+			if(bridge == null)
+				throw new ArgumentNullException("bridge");
+			if(options == null)
+				throw new ArgumentNullException("options");
+			if(options.BatchSize < 1)
+				throw new ArgumentOutOfRangeException("options", "BatchSize must be positive");
+
+			var session = table.Session;
+			var progress = new BulkInsertProgress();
+			var timer = Stopwatch.StartNew();
+			Transaction tr = null;
+
+			try
+			{
+				using(var csr = new Cursor(table))
+				using(var e = rows.GetEnumerator())
+				{
+					bool more = e.MoveNext();
+
+					while(more)
+					{
+						int in_batch = 0;
+						bool full;
+
+						tr = new Transaction(session);
+
+						do
+						{
+							using(var u = csr.BeginInsert())
+							{
+								bridge.Write(u, e.Current);
+								u.Complete();
+							}
+
+							in_batch++;
+
+							full = in_batch >= options.BatchSize ||
+								(options.VersionStoreCheckInterval > 0 && in_batch % options.VersionStoreCheckInterval == 0 && session.IsVersionStoreHalfFull);
+
+							more = e.MoveNext();
+						} while(more && !full);
+
+						//only the last batch needs to wait for the log flush, which also covers the lazy commits before it
+						if(more)
+							tr.CommitLazyFlush();
+						else
+							tr.Commit();
+
+						tr = null;
+
+						progress.Rows += in_batch;
+						progress.Batches++;
+						progress.Elapsed = timer.Elapsed;
+
+						if(options.Progress != null)
+							options.Progress(progress);
+					}
+				}
+			}
+			finally
+			{
+				if(tr != null)
+					tr.Dispose();
+			}
+
+			progress.Elapsed = timer.Elapsed;
+			return progress;
+		}
+	}
+}
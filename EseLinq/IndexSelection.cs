@@ -0,0 +1,704 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  IndexSelection
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+
+using EseObjects;
+using EseLinq.Storage;
+
+namespace EseLinq
+{
+	/// <summary>
+	/// A value compared with a key column. Evaluated each time the query runs, so captured variables have their current values.
+	/// </summary>
+	internal class KeyValue
+	{
+		internal readonly Column Col;
+		internal readonly Type MemberType;
+		readonly Func<object> value;
+
+		internal KeyValue(Column Col, Type MemberType, Expression value)
+		{
+			this.Col = Col;
+			this.MemberType = MemberType;
+			this.value = Expression.Lambda<Func<object>>(Expression.Convert(value, typeof(object))).Compile();
+		}
+
+		//value as the member type, which is how Flat stores it
+		//false if it's null or doesn't convert exactly, as with comparing a short member to 40000
+		internal bool TryGet(out object key)
+		{
+			object v = value();
+			Type ty = Nullable.GetUnderlyingType(MemberType) ?? MemberType;
+
+			key = v;
+
+			if(v == null)
+				return false;
+			if(v.GetType() == ty)
+				return true;
+
+			try
+			{
+				key = ty.IsEnum ? Enum.ToObject(ty, v) : Convert.ChangeType(v, ty);
+				return Convert.ChangeType(key, v.GetType()).Equals(v);
+			}
+			catch(InvalidCastException)
+			{
+				return false;
+			}
+			catch(OverflowException)
+			{
+				return false;
+			}
+			catch(ArgumentException)
+			{
+				return false;
+			}
+		}
+
+		public override string ToString()
+		{
+			object v = value();
+			return v == null ? "null" : v.ToString();
+		}
+	}
+
+	/// <summary>
+	/// The count of a Skip or Take. Evaluated each time the query runs, as KeyValue is, unless it's a constant.
+	/// </summary>
+	internal class PageCount
+	{
+		internal readonly bool Take;
+		readonly Func<int> count;
+		readonly int constant;
+
+		internal PageCount(bool Take, Expression count)
+		{
+			var c = count as ConstantExpression;
+
+			this.Take = Take;
+			if(c != null)
+				constant = (int)c.Value;
+			else
+				this.count = Expression.Lambda<Func<int>>(count).Compile();
+		}
+
+		//current count; negative counts are treated as 0, as LINQ to Objects does
+		internal long Value
+		{
+			get
+			{
+				return Math.Max(0, count == null ? constant : count());
+			}
+		}
+	}
+
+	/// <summary>
+	/// Part of an index selected by a predicate: equal values for leading key columns, then optionally bounds on the next key column.
+	/// </summary>
+	internal class KeyRange
+	{
+		internal readonly List<KeyValue> Equal = new List<KeyValue>();
+		//bounds in index order, so for a descending column First is the predicate's upper bound
+		internal KeyValue First;
+		internal KeyValue Last;
+		internal bool LastInclusive;
+
+		//keys to seek to and limit at, reading forward or backward through the range
+		//false if a value can't be used in a key, in which case the caller checks the whole predicate instead
+		internal bool TryMakeKeys(bool backward, out Seekable start, out Limitable end)
+		{
+			var first = new List<Field>();
+			object key;
+
+			start = null;
+			end = null;
+
+			foreach(KeyValue kv in Equal)
+			{
+				if(!kv.TryGet(out key))
+					return false;
+
+				first.Add(new Field(kv.Col, key));
+			}
+
+			var last = new List<Field>(first);
+
+			if(First != null)
+			{
+				if(!First.TryGet(out key))
+					return false;
+
+				first.Add(new Field(First.Col, key));
+			}
+
+			if(Last != null)
+			{
+				if(!Last.TryGet(out key))
+					return false;
+
+				last.Add(new Field(Last.Col, key));
+			}
+
+			//an exclusive First is sought inclusively and left in the residual predicate, since seeking with an end wildcard isn't supported
+			//backward, an exclusive Last is sought inclusively the same way; see LastChecked
+			if(backward)
+			{
+				if(last.Count > 0)
+					start = new FieldPosition(last.ToArray(), Match.WildcardEnd, SeekRel.LE);
+
+				if(first.Count > 0)
+					end = new FieldPosition(first.ToArray(), Match.WildcardStart, SeekRel.GE);
+			}
+			else
+			{
+				if(first.Count > 0)
+					start = new FieldPosition(first.ToArray(), Match.WildcardStart, SeekRel.GE);
+
+				if(last.Count > 0)
+					end = Last != null && !LastInclusive ?
+						new FieldPosition(last.ToArray(), Match.WildcardStart, SeekRel.LT) :
+						new FieldPosition(last.ToArray(), Match.WildcardEnd, SeekRel.LE);
+			}
+
+			return true;
+		}
+
+		//true if the keys made for reading in that direction include rows the range doesn't, so the whole predicate has to be checked
+		internal bool LastChecked(bool backward)
+		{
+			return backward && Last != null && !LastInclusive;
+		}
+
+		//in index order, for Provider.Log: "sensor = 2, value from 10 before 4"
+		public override string ToString()
+		{
+			var parts = new List<string>();
+
+			foreach(KeyValue kv in Equal)
+				parts.Add(kv.Col.Name + " = " + kv);
+
+			if(First != null || Last != null)
+			{
+				string bounds = (First ?? Last).Col.Name;
+
+				if(First != null)
+					bounds += " from " + First;
+				if(Last != null)
+					bounds += (LastInclusive ? " to " : " before ") + Last;
+
+				parts.Add(bounds);
+			}
+
+			return string.Join(", ", parts.ToArray());
+		}
+	}
+
+	/// <summary>
+	/// A key rows are sorted by, from OrderBy or ThenBy.
+	/// </summary>
+	internal class SortKey<T>
+	{
+		//column the key reads directly, or null if it's computed or uses its own comparer; only then can an index give the order
+		internal readonly Column Col;
+		internal readonly Type MemberType;
+		internal readonly bool Descending;
+		readonly Func<T, object> key;
+		readonly IComparer<object> comparer;
+
+		internal SortKey(Column Col, LambdaExpression selector, object comparer, bool Descending)
+		{
+			Type key_type = selector.Body.Type;
+
+			this.Col = comparer == null ? Col : null;
+			this.MemberType = key_type;
+			this.Descending = Descending;
+			this.key = Expression.Lambda<Func<T, object>>(Expression.Convert(selector.Body, typeof(object)), selector.Parameters).Compile();
+			this.comparer = (IComparer<object>)Activator.CreateInstance(typeof(KeyComparer<>).MakeGenericType(key_type), comparer);
+		}
+
+		//sorts rows by this key, or sorted further by it if they're sorted already
+		internal IOrderedEnumerable<T> Apply(IEnumerable<T> rows, IOrderedEnumerable<T> sorted)
+		{
+			if(sorted == null)
+				return Descending ? rows.OrderByDescending(key, comparer) : rows.OrderBy(key, comparer);
+
+			return Descending ? sorted.ThenByDescending(key, comparer) : sorted.ThenBy(key, comparer);
+		}
+	}
+
+	//compares boxed keys as the typed comparer does, so sorting matches LINQ to Objects
+	internal class KeyComparer<TKey> : IComparer<object>
+	{
+		readonly IComparer<TKey> comparer;
+
+		public KeyComparer(IComparer<TKey> comparer)
+		{
+			this.comparer = comparer ?? Comparer<TKey>.Default;
+		}
+
+		public int Compare(object a, object b)
+		{
+			return comparer.Compare((TKey)a, (TKey)b);
+		}
+	}
+
+	/// <summary>
+	/// Chooses an index and key range for a predicate from its comparisons of members stored by Flat with values that don't depend on the row.
+	/// </summary>
+	internal static class IndexSelection
+	{
+		//a conjunct comparing a stored member with a value, with the member on the left
+		class Comparison
+		{
+			internal Expression Conjunct;
+			internal Column Col;
+			internal Type MemberType;
+			internal ExpressionType Op;
+			internal Expression Value;
+		}
+
+		static void SplitConjuncts(Expression e, List<Expression> conjuncts)
+		{
+			if(e.NodeType == ExpressionType.AndAlso)
+			{
+				var b = (BinaryExpression)e;
+
+				SplitConjuncts(b.Left, conjuncts);
+				SplitConjuncts(b.Right, conjuncts);
+			}
+			else
+				conjuncts.Add(e);
+		}
+
+		//true if e can be evaluated without the row; conservative, so anything unusual counts as depending on it
+		internal static bool RowIndependent(Expression e)
+		{
+			if(e == null)
+				return true;
+
+			switch(e.NodeType)
+			{
+			case ExpressionType.Constant:
+				return true;
+
+			case ExpressionType.MemberAccess:
+				return RowIndependent(((MemberExpression)e).Expression);
+
+			case ExpressionType.Convert:
+			case ExpressionType.ConvertChecked:
+			case ExpressionType.Negate:
+			case ExpressionType.NegateChecked:
+			case ExpressionType.UnaryPlus:
+			case ExpressionType.Not:
+				return RowIndependent(((UnaryExpression)e).Operand);
+
+			case ExpressionType.Add:
+			case ExpressionType.AddChecked:
+			case ExpressionType.Subtract:
+			case ExpressionType.SubtractChecked:
+			case ExpressionType.Multiply:
+			case ExpressionType.MultiplyChecked:
+			case ExpressionType.Divide:
+			case ExpressionType.Modulo:
+			case ExpressionType.ArrayIndex:
+			case ExpressionType.Coalesce:
+				{
+					var b = (BinaryExpression)e;
+					return RowIndependent(b.Left) && RowIndependent(b.Right);
+				}
+
+			case ExpressionType.Call:
+				{
+					var m = (MethodCallExpression)e;
+					return RowIndependent(m.Object) && m.Arguments.All(RowIndependent);
+				}
+
+			case ExpressionType.New:
+				return ((NewExpression)e).Arguments.All(RowIndependent);
+
+			default:
+				return false;
+			}
+		}
+
+		//member of the row parameter that e reads, looking through conversions
+		static MemberExpression RowMember(Expression e, ParameterExpression row)
+		{
+			while(e.NodeType == ExpressionType.Convert || e.NodeType == ExpressionType.ConvertChecked)
+				e = ((UnaryExpression)e).Operand;
+
+			var m = e as MemberExpression;
+
+			return m != null && m.Expression == row ? m : null;
+		}
+
+		static ExpressionType Flip(ExpressionType op)
+		{
+			switch(op)
+			{
+			case ExpressionType.LessThan:
+				return ExpressionType.GreaterThan;
+			case ExpressionType.LessThanOrEqual:
+				return ExpressionType.GreaterThanOrEqual;
+			case ExpressionType.GreaterThan:
+				return ExpressionType.LessThan;
+			case ExpressionType.GreaterThanOrEqual:
+				return ExpressionType.LessThanOrEqual;
+			default:
+				return op;
+			}
+		}
+
+		static Comparison Analyze<T>(Expression conjunct, ParameterExpression row, Flat<T> flat)
+		{
+			MemberExpression member;
+			ExpressionType op;
+			Expression value;
+
+			switch(conjunct.NodeType)
+			{
+			case ExpressionType.Equal:
+			case ExpressionType.LessThan:
+			case ExpressionType.LessThanOrEqual:
+			case ExpressionType.GreaterThan:
+			case ExpressionType.GreaterThanOrEqual:
+				{
+					var b = (BinaryExpression)conjunct;
+
+					if((member = RowMember(b.Left, row)) != null && RowIndependent(b.Right))
+					{
+						op = b.NodeType;
+						value = b.Right;
+					}
+					else if((member = RowMember(b.Right, row)) != null && RowIndependent(b.Left))
+					{
+						op = Flip(b.NodeType);
+						value = b.Left;
+					}
+					else
+						return null;
+				}
+				break;
+
+			case ExpressionType.MemberAccess:
+			case ExpressionType.Not:
+				//bool member alone, or negated
+				{
+					bool negated = conjunct.NodeType == ExpressionType.Not;
+
+					member = RowMember(negated ? ((UnaryExpression)conjunct).Operand : conjunct, row);
+					if(member == null || member.Type != typeof(bool))
+						return null;
+
+					op = ExpressionType.Equal;
+					value = Expression.Constant(!negated);
+				}
+				break;
+
+			default:
+				return null;
+			}
+
+			Column col = flat.ColumnFor(member.Member);
+
+			//-0.0 and +0.0 are equal in .NET but normalize to different keys, so no key range can bound them both
+			if(col == null || col.ColumnType == Column.Type.SingleFloat || col.ColumnType == Column.Type.DoubleFloat)
+				return null;
+
+			return new Comparison
+			{
+				Conjunct = conjunct,
+				Col = col,
+				MemberType = member.Type,
+				Op = op,
+				Value = value
+			};
+		}
+
+		//key columns whose normalized key compares exactly as .NET compares the values
+		//text is case insensitive and can be truncated, floating point has -0 and NaN and dates lose precision, so those comparisons are also checked in memory
+		static bool ExactKey(Column col)
+		{
+			switch(col.ColumnType)
+			{
+			case Column.Type.Bit:
+			case Column.Type.UnsignedByte:
+			case Column.Type.Short:
+			case Column.Type.UnsignedShort:
+			case Column.Type.Long:
+			case Column.Type.UnsignedLong:
+			case Column.Type.LongLong:
+			case Column.Type.Currency:
+			case Column.Type.GUID:
+				return true;
+
+			default:
+				return false;
+			}
+		}
+
+		//key columns that sort as Comparer<T>.Default does, so reading the index gives the order LINQ to Objects would
+		//GUID keys are ordered differently than Guid.CompareTo
+		static bool OrderedKey(Column col)
+		{
+			return ExactKey(col) && col.ColumnType != Column.Type.GUID;
+		}
+
+		static bool SameColumn(Column col, Index.KeyColumn kc)
+		{
+			return string.Equals(col.Name, kc.Name, StringComparison.OrdinalIgnoreCase);
+		}
+
+		//false for indexes that leave rows out or list them more than once, or might
+		//a conditional index leaves out rows by other columns, one keyed on a multivalued column lists a row once per value
+		static bool AllRows(Index ix)
+		{
+			if(ix.TupleIndex || ix.CrossProduct || ix.IgnoreAnyNull || ix.IgnoreFirstNull || ix.IgnoreAllNull)
+				return false;
+
+			if(ix.ConditionalColumns == null || ix.ConditionalColumns.Any())
+				return false;
+
+			return !ix.KeyColumns.Any(kc => kc.MultiValued);
+		}
+
+		/// <summary>
+		/// Column a sort key reads, if it's a member stored by Flat.
+		/// </summary>
+		internal static Column OrderColumn<T>(Flat<T> flat, LambdaExpression selector)
+		{
+			var m = selector.Body as MemberExpression;
+
+			return m != null && m.Expression == selector.Parameters[0] ? flat.ColumnFor(m.Member) : null;
+		}
+
+		/// <summary>
+		/// Checks if reading part of an index gives rows in the order of the sort keys.
+		/// </summary>
+		/// <param name="ix">Index to read.</param>
+		/// <param name="range">Range of the index read, or null for all of it. Key columns held equal by it are skipped.</param>
+		/// <param name="order">Sort keys, outermost first.</param>
+		/// <param name="backward">Set to true if the index has to be read backward.</param>
+		internal static bool MatchOrder<T>(Index ix, KeyRange range, IList<SortKey<T>> order, out bool backward)
+		{
+			var keys = new List<Index.KeyColumn>(ix.KeyColumns);
+			int next = range == null ? 0 : range.Equal.Count;
+			bool? back = null;
+
+			backward = false;
+
+			if(!AllRows(ix))
+				return false;
+
+			foreach(SortKey<T> sk in order)
+			{
+				if(sk.Col == null)
+					return false;
+
+				//every row read has the same value for these
+				if(range != null && range.Equal.Exists(kv => string.Equals(kv.Col.Name, sk.Col.Name, StringComparison.OrdinalIgnoreCase)))
+					continue;
+
+				if(next >= keys.Count || !SameColumn(sk.Col, keys[next]) || !OrderedKey(sk.Col))
+					return false;
+
+				//nulls come first in LINQ to Objects
+				if(ix.NullSortedHigh && Nullable.GetUnderlyingType(sk.MemberType) != null)
+					return false;
+
+				bool b = keys[next].SortDescending != sk.Descending;
+
+				if(back.HasValue && back.Value != b)
+					return false;
+
+				back = b;
+				next++;
+			}
+
+			backward = back ?? false;
+			return true;
+		}
+
+		/// <summary>
+		/// Chooses an index that gives rows in the order of the sort keys, preferring the primary index.
+		/// </summary>
+		/// <returns>The index, or null if the rows have to be sorted.</returns>
+		internal static Index ChooseOrder<T>(Table table, IList<SortKey<T>> order, out bool backward)
+		{
+			Index found = null;
+
+			backward = false;
+
+			foreach(Index ix in table.Indexes)
+			{
+				bool b;
+
+				if(MatchOrder(ix, null, order, out b) && (found == null || ix.Primary))
+				{
+					found = ix;
+					backward = b;
+				}
+			}
+
+			return found;
+		}
+
+		/// <summary>
+		/// Chooses the index whose leading key columns are most constrained by the predicate: the most equality comparisons, then a range on the next column.
+		/// </summary>
+		/// <param name="flat">Mapping of members to columns.</param>
+		/// <param name="indexes">Indexes to choose from.</param>
+		/// <param name="predicate">Predicate to translate.</param>
+		/// <param name="index">Chosen index.</param>
+		/// <param name="residual">Part of the predicate the range doesn't guarantee, or null if every row in the range qualifies.</param>
+		/// <returns>Range of the chosen index, or null if no index helps. Then residual is the whole predicate.</returns>
+		internal static KeyRange Choose<T>(Flat<T> flat, IEnumerable<Index> indexes, Expression<Func<T, bool>> predicate, out Index index, out Expression<Func<T, bool>> residual)
+		{
+			ParameterExpression row = predicate.Parameters[0];
+			var conjuncts = new List<Expression>();
+			var comparisons = new List<Comparison>();
+
+			SplitConjuncts(predicate.Body, conjuncts);
+
+			foreach(Expression c in conjuncts)
+			{
+				Comparison cmp = Analyze(c, row, flat);
+
+				if(cmp != null)
+					comparisons.Add(cmp);
+			}
+
+			index = null;
+			residual = predicate;
+
+			if(comparisons.Count == 0)
+				return null;
+
+			int best_score = 0;
+			List<Comparison> best_equal = null;
+			Comparison best_lower = null, best_upper = null;
+			bool best_descending = false;
+
+			foreach(Index ix in indexes)
+			{
+				if(!AllRows(ix))
+					continue;
+
+				var equal = new List<Comparison>();
+				Comparison lower = null, upper = null;
+				bool descending = false;
+
+				foreach(Index.KeyColumn kc in ix.KeyColumns)
+				{
+					Comparison eq = comparisons.FirstOrDefault(c => c.Op == ExpressionType.Equal && SameColumn(c.Col, kc));
+
+					if(eq != null)
+					{
+						equal.Add(eq);
+						continue;
+					}
+
+					lower = comparisons.FirstOrDefault(c => (c.Op == ExpressionType.GreaterThan || c.Op == ExpressionType.GreaterThanOrEqual) && SameColumn(c.Col, kc));
+					upper = comparisons.FirstOrDefault(c => (c.Op == ExpressionType.LessThan || c.Op == ExpressionType.LessThanOrEqual) && SameColumn(c.Col, kc));
+					descending = kc.SortDescending;
+					break;
+				}
+
+				int score = equal.Count * 2 + (lower != null || upper != null ? 1 : 0);
+
+				if(score > best_score || (score == best_score && score > 0 && ix.Primary))
+				{
+					best_score = score;
+					index = ix;
+					best_equal = equal;
+					best_lower = lower;
+					best_upper = upper;
+					best_descending = descending;
+				}
+			}
+
+			if(best_score == 0)
+			{
+				index = null;
+				return null;
+			}
+
+			//a comparison is only left out of the residual when the key range answers it exactly
+			//that needs an exact key type and a member that can't be null, since nulls sort into the range; an exclusive First is still checked, see KeyRange
+			var range = new KeyRange();
+			var consumed = new List<Expression>();
+
+			foreach(Comparison eq in best_equal)
+			{
+				range.Equal.Add(new KeyValue(eq.Col, eq.MemberType, eq.Value));
+
+				if(ExactKey(eq.Col) && Nullable.GetUnderlyingType(eq.MemberType) == null)
+					consumed.Add(eq.Conjunct);
+			}
+
+			Comparison first = best_descending ? best_upper : best_lower;
+			Comparison last = best_descending ? best_lower : best_upper;
+
+			if(first != null)
+			{
+				range.First = new KeyValue(first.Col, first.MemberType, first.Value);
+
+				if(ExactKey(first.Col) && Nullable.GetUnderlyingType(first.MemberType) == null && (first.Op == ExpressionType.GreaterThanOrEqual || first.Op == ExpressionType.LessThanOrEqual))
+					consumed.Add(first.Conjunct);
+			}
+
+			if(last != null)
+			{
+				range.Last = new KeyValue(last.Col, last.MemberType, last.Value);
+				range.LastInclusive = last.Op == ExpressionType.GreaterThanOrEqual || last.Op == ExpressionType.LessThanOrEqual;
+
+				if(ExactKey(last.Col) && Nullable.GetUnderlyingType(last.MemberType) == null)
+					consumed.Add(last.Conjunct);
+			}
+
+			Expression rest = null;
+
+			foreach(Expression c in conjuncts)
+				if(!consumed.Contains(c))
+					rest = rest == null ? c : Expression.AndAlso(rest, c);
+
+			residual = rest == null ? null : Expression.Lambda<Func<T, bool>>(rest, row);
+
+			return range;
+		}
+	}
+}
@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Linq;
 using System.Linq.Expressions;
 using System.Text;
@@ -20,12 +21,142 @@ namespace EseLinq
 			this.sess = sess;
 		}
 
+		/// <summary>
+		/// Skip counts at least this large move the cursor to an approximate position in the index instead of past each entry.
+		/// Much faster for deep pages, but the page may start some rows early or late. Only used when a whole index is read and every row qualifies.
+		/// Zero, the default, always skips exactly.
+		/// </summary>
+		public int ApproximateSkipThreshold
+		{
+			get;
+			set;
+		}
+
+		/// <summary>
+		/// Receives a line describing each table scan as it runs: the index read, in which direction, and the key range read from it, if any.
+		/// Rows that no index gives the order of are logged as sorted before the scan reading them.
+		/// When only some members are read, a line lists the columns retrieved for each row.
+		/// Count, LongCount and Any log whether they counted index entries or how many rows they read, and Skip whether it moved past entries or read rows.
+		/// Null, the default, for none.
+		/// </summary>
+		public TextWriter Log
+		{
+			get;
+			set;
+		}
+
+		internal void WriteLog(string format, params object[] args)
+		{
+			if(Log != null)
+				Log.WriteLine(format, args);
+		}
+
 		public IQueryable<T> CreateQuery<T>(Expression exp)
 		{
+			IQueryable<T> translated = Translate<T>(exp);
+
+			if(translated != null)
+				return translated;
+
 			var args = new ParameterExpression[0];
 			return Expression.Lambda<Func<IQueryable<T>>>(exp, args).Compile()();
 		}
 
+		static Expression StripQuotes(Expression exp)
+		{
+			while(exp.NodeType == ExpressionType.Quote)
+				exp = ((UnaryExpression)exp).Operand;
+
+			return exp;
+		}
+
+		//the table scan read by a query expression made by Query over one, or null for any other expression
+		static object ScanOf(Expression exp)
+		{
+			var inv = exp as InvocationExpression;
+			var lambda = inv == null ? null : inv.Expression as LambdaExpression;
+			var call = lambda == null ? null : lambda.Body as MethodCallExpression;
+			var scan = call == null ? null : call.Object as ConstantExpression;
+
+			return scan == null ? null : scan.Value;
+		}
+
+		/// <summary>
+		/// Applies a query operator to the table scan it reads instead of running it over every row in memory.
+		/// Where with comparisons of indexed columns becomes a seek and range on the best index.
+		/// OrderBy and ThenBy read an index in that order, forward or backward, when one matches and sort the rows otherwise.
+		/// Select only retrieves the columns of members the query reads.
+		/// Skip moves the cursor past entries without reading them if it can and Take stops reading.
+		/// </summary>
+		/// <returns>The translated query, or null to run exp with LINQ to Objects.</returns>
+		IQueryable<T> Translate<T>(Expression exp)
+		{
+			var call = exp as MethodCallExpression;
+
+			if(call == null || call.Method.DeclaringType != typeof(Queryable))
+				return null;
+
+			switch(call.Method.Name)
+			{
+			case "Where":
+				{
+					var scan = ScanOf(call.Arguments[0]) as TableScan<T>;
+					var pred = StripQuotes(call.Arguments[1]) as Expression<Func<T, bool>>;
+
+					if(scan == null || scan.Paged || pred == null)
+						return null;
+
+					return new Query<T>(this, scan.Where(pred));
+				}
+
+			case "OrderBy":
+			case "OrderByDescending":
+			case "ThenBy":
+			case "ThenByDescending":
+				{
+					var scan = ScanOf(call.Arguments[0]) as TableScan<T>;
+					var key = StripQuotes(call.Arguments[1]) as LambdaExpression;
+					object comparer = null;
+
+					if(scan == null || scan.Paged || key == null)
+						return null;
+
+					if(call.Arguments.Count > 2)
+						comparer = Expression.Lambda<Func<object>>(Expression.Convert(call.Arguments[2], typeof(object))).Compile()();
+
+					return new Query<T>(this, scan.OrderBy(key, comparer, call.Method.Name.EndsWith("Descending"), call.Method.Name.StartsWith("ThenBy")));
+				}
+
+			case "Skip":
+			case "Take":
+				{
+					var scan = ScanOf(call.Arguments[0]) as TableScan<T>;
+					Expression count = call.Arguments[1];
+
+					//a count made from captured variables is evaluated each time the query runs
+					if(scan == null || !IndexSelection.RowIndependent(count))
+						return null;
+
+					return new Query<T>(this, scan.Page(call.Method.Name == "Take", count, ApproximateSkipThreshold));
+				}
+
+			case "Select":
+				{
+					var scan = ScanOf(call.Arguments[0]) as ITableScan;
+					var sel = StripQuotes(call.Arguments[1]) as LambdaExpression;
+
+					//the overload passing the index isn't translated
+					if(scan == null || sel == null || sel.Parameters.Count != 1)
+						return null;
+
+					return scan.Select<T>(this, sel);
+				}
+
+			default:
+				return null;
+			}
+		}
+
 		public IQueryable CreateQuery(Expression exp)
 		{
 			try
@@ -41,8 +172,59 @@ namespace EseLinq
 			}
 		}
 
+		/// <summary>
+		/// Runs an operator returning a single value from the table scan it reads instead of over every row in memory.
+		/// Count, LongCount and Any count index entries in the key range chosen for their predicate, Any stopping at the first.
+		/// </summary>
+		/// <returns>False to run exp with LINQ to Objects.</returns>
+		bool TryExecute(Expression exp, out object result)
+		{
+			var call = exp as MethodCallExpression;
+			LambdaExpression pred = null;
+
+			result = null;
+
+			if(call == null || call.Method.DeclaringType != typeof(Queryable))
+				return false;
+
+			var scan = ScanOf(call.Arguments[0]) as ITableScan;
+
+			if(scan == null)
+				return false;
+
+			if(call.Arguments.Count > 1)
+			{
+				pred = StripQuotes(call.Arguments[1]) as LambdaExpression;
+				if(pred == null)
+					return false;
+			}
+
+			switch(call.Method.Name)
+			{
+			case "Count":
+				result = checked((int)scan.Count(pred, long.MaxValue));
+				return true;
+
+			case "LongCount":
+				result = scan.Count(pred, long.MaxValue);
+				return true;
+
+			case "Any":
+				result = scan.Count(pred, 1) > 0;
+				return true;
+
+			default:
+				return false;
+			}
+		}
+
 		public T Execute<T>(Expression exp)
 		{
+			object result;
+
+			if(TryExecute(exp, out result))
+				return (T)result;
+
 			var args = new ParameterExpression[0];
 			var lambda = Expression.Lambda<Func<T>>(exp, args);
 			return lambda.Compile().Invoke();
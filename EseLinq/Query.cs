@@ -13,7 +13,7 @@ namespace EseLinq
 	/// A Query represents a LINQ expression tree applied to an EseLinq data source.
 	/// </summary>
 	/// <typeparam name="T">Type of the object representing each element.</typeparam>
-	public class Query<T> : IQueryable<T>, IQueryable //, IOrderedQueryable<T>, IOrderedQueryable
+	public class Query<T> : IQueryable<T>, IQueryable, IOrderedQueryable<T>, IOrderedQueryable
 	{
 		readonly Expression exp;
 		readonly Provider provider;
@@ -37,6 +37,17 @@ namespace EseLinq
 			this.exec = exp;
 		}
 
+		//query over a table scan, which Provider recognizes in exp to translate operators applied to it
+		//exp is typed as ordered so ThenBy can be applied after a translated OrderBy
+		internal Query(Provider provider, TableScan<T> scan)
+		{
+			var read = Expression.Lambda<Func<IOrderedQueryable<T>>>(Expression.Call(Expression.Constant(scan), typeof(TableScan<T>).GetMethod("AsQueryable")));
+
+			this.provider = provider;
+			this.exp = Expression.Invoke(read, new Expression[0]);
+			this.exec = Expression.Lambda<Func<IQueryable<T>>>(read.Body, new ParameterExpression[0]);
+		}
+
 		public Type ElementType
 		{
 			get
@@ -0,0 +1,186 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  RowMembers
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq.Expressions;
+using System.Reflection;
+
+namespace EseLinq
+{
+	/// <summary>
+	/// Finds the members of the row a lambda reads, so only their columns need to be retrieved.
+	/// </summary>
+	internal static class RowMembers
+	{
+		/// <summary>
+		/// Adds the members of the lambda's row parameter it reads to members.
+		/// </summary>
+		/// <returns>False if the lambda uses the row other than by reading its members, or has expressions that aren't understood, in which case all of the row is needed.</returns>
+		internal static bool Collect(LambdaExpression lambda, ICollection<MemberInfo> members)
+		{
+			return Visit(lambda.Body, lambda.Parameters[0], members);
+		}
+
+		static bool Visit(ReadOnlyCollection<Expression> exps, ParameterExpression row, ICollection<MemberInfo> members)
+		{
+			foreach(Expression e in exps)
+				if(!Visit(e, row, members))
+					return false;
+
+			return true;
+		}
+
+		static bool Visit(ReadOnlyCollection<MemberBinding> bindings, ParameterExpression row, ICollection<MemberInfo> members)
+		{
+			foreach(MemberBinding b in bindings)
+			{
+				switch(b.BindingType)
+				{
+				case MemberBindingType.Assignment:
+					if(!Visit(((MemberAssignment)b).Expression, row, members))
+						return false;
+					break;
+
+				case MemberBindingType.MemberBinding:
+					if(!Visit(((MemberMemberBinding)b).Bindings, row, members))
+						return false;
+					break;
+
+				case MemberBindingType.ListBinding:
+					foreach(ElementInit ei in ((MemberListBinding)b).Initializers)
+						if(!Visit(ei.Arguments, row, members))
+							return false;
+					break;
+
+				default:
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		static bool Visit(Expression e, ParameterExpression row, ICollection<MemberInfo> members)
+		{
+			if(e == null)
+				return true;
+
+			switch(e.NodeType)
+			{
+			case ExpressionType.Constant:
+				return true;
+
+			case ExpressionType.Parameter:
+				//the row itself, as opposed to parameters of nested lambdas
+				return e != row;
+
+			case ExpressionType.MemberAccess:
+				{
+					var m = (MemberExpression)e;
+
+					if(m.Expression == row)
+					{
+						members.Add(m.Member);
+						return true;
+					}
+
+					return Visit(m.Expression, row, members);
+				}
+
+			case ExpressionType.Call:
+				{
+					var m = (MethodCallExpression)e;
+					return Visit(m.Object, row, members) && Visit(m.Arguments, row, members);
+				}
+
+			case ExpressionType.Conditional:
+				{
+					var c = (ConditionalExpression)e;
+					return Visit(c.Test, row, members) && Visit(c.IfTrue, row, members) && Visit(c.IfFalse, row, members);
+				}
+
+			case ExpressionType.TypeIs:
+				return Visit(((TypeBinaryExpression)e).Expression, row, members);
+
+			case ExpressionType.Invoke:
+				{
+					var i = (InvocationExpression)e;
+					return Visit(i.Expression, row, members) && Visit(i.Arguments, row, members);
+				}
+
+			case ExpressionType.Lambda:
+				return Visit(((LambdaExpression)e).Body, row, members);
+
+			case ExpressionType.New:
+				return Visit(((NewExpression)e).Arguments, row, members);
+
+			case ExpressionType.NewArrayInit:
+			case ExpressionType.NewArrayBounds:
+				return Visit(((NewArrayExpression)e).Expressions, row, members);
+
+			case ExpressionType.MemberInit:
+				{
+					var mi = (MemberInitExpression)e;
+					return Visit(mi.NewExpression, row, members) && Visit(mi.Bindings, row, members);
+				}
+
+			case ExpressionType.ListInit:
+				{
+					var li = (ListInitExpression)e;
+
+					if(!Visit(li.NewExpression, row, members))
+						return false;
+
+					foreach(ElementInit ei in li.Initializers)
+						if(!Visit(ei.Arguments, row, members))
+							return false;
+
+					return true;
+				}
+
+			default:
+				{
+					var u = e as UnaryExpression;
+					if(u != null)
+						return Visit(u.Operand, row, members);
+
+					var b = e as BinaryExpression;
+					if(b != null)
+						return Visit(b.Left, row, members) && Visit(b.Right, row, members) && Visit(b.Conversion, row, members);
+
+					return false;
+				}
+			}
+		}
+	}
+}
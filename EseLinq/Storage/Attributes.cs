@@ -197,6 +197,14 @@ namespace EseLinq.Storage
 	public class XmlFieldSerializationAttribute : Attribute
 	{}
 
+	///<summary>Directs EseObjects to compress values of this field's LongText or LongBinary column that are at least MinSize bytes. See Column.CompressionThreshold.</summary>
+	[AttributeUsageAttribute(AttributeTargets.Field | AttributeTargets.Property)]
+	public class CompressedFieldAttribute : Attribute
+	{
+		///<summary>Smallest value size in bytes to compress. Smaller values gain little and are stored as is.</summary>
+		public uint MinSize = 1024;
+	}
+
 	///<summary>By default, classes use reference semantics when storing references. This overrides that behavior to use value semantics (with primary key definition) instead.</summary>
 	[AttributeUsageAttribute(AttributeTargets.Field | AttributeTargets.Property)]
 	public class UseValueSemanticsAttribute : Attribute
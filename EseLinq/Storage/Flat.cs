@@ -35,8 +35,6 @@ using System.Runtime.Serialization;
 using System.Reflection;
 using EseObjects;
 
-using System.Runtime.Serialization.Formatters.Binary;
-
 namespace EseLinq.Storage
 {
 	public class Flat<T> : IRecordBridge<T>
@@ -44,10 +42,12 @@ namespace EseLinq.Storage
 		//base linkage to .NET member
 		protected abstract class MemberLink
 		{
+			public MemberInfo Mi;
 			public Type MemberType;
 
-			public MemberLink(Type MemberType)
+			public MemberLink(MemberInfo Mi, Type MemberType)
 			{
+				this.Mi = Mi;
 				this.MemberType = MemberType;
 			}
 
@@ -61,7 +61,7 @@ namespace EseLinq.Storage
 			public FieldInfo Fi;
 
 			public FieldLink(FieldInfo Fi) :
-				base(Fi.FieldType)
+				base(Fi, Fi.FieldType)
 			{
 				this.Fi = Fi;
 			}
@@ -83,7 +83,7 @@ namespace EseLinq.Storage
 			public MethodInfo SetMi;
 
 			public PropertyLink(PropertyInfo Pi) :
-				base(Pi.PropertyType)
+				base(Pi, Pi.PropertyType)
 			{
 				GetMi = Pi.GetGetMethod();
 				SetMi = Pi.GetSetMethod();
@@ -126,26 +126,41 @@ namespace EseLinq.Storage
 
 		protected class BinaryColumnLink : ColumnLink
 		{
-			public BinaryFormatter formatter;
+			public IValueSerializer Serializer;
 
-			public BinaryColumnLink(MemberLink Ml, Column Col) :
+			public BinaryColumnLink(MemberLink Ml, Column Col, IValueSerializer Serializer) :
 				base(Ml, Col)
 			{
-				formatter = new BinaryFormatter();
+				this.Serializer = Serializer;
 			}
 
+			//serialized as the member's declared type, so both sides use the same format; null is a null column
 			public override void SaveField(object obj, IWriteRecord wr)
 			{
+				object value = Ml.Get(obj);
+
+				if(value == null)
+				{
+					wr.Set(Col, (object)null);
+					return;
+				}
+
 				System.IO.MemoryStream stream = new System.IO.MemoryStream();
-				formatter.Serialize(stream, Ml.Get(obj));
+				Serializer.Serialize(Ml.MemberType, value, stream);
 				
 				wr.Set(Col, stream.ToArray());
 			}
 			public override void LoadField(object obj, IReadRecord rr)
 			{
-				System.IO.MemoryStream stream = new System.IO.MemoryStream(rr.Retrieve<byte[]>(Col));
+				byte[] bytes = rr.Retrieve<byte[]>(Col);
+
+				if(bytes == null)
+				{
+					Ml.Set(obj, null);
+					return;
+				}
 
-				Ml.Set(obj, formatter.Deserialize(stream));
+				Ml.Set(obj, Serializer.Deserialize(Ml.MemberType, new System.IO.MemoryStream(bytes)));
 			}
 		}
 
@@ -180,10 +195,10 @@ namespace EseLinq.Storage
 		{
 			public ColumnLink[] Links;
 
-			public ExpandedColumnLink(MemberLink Ml, string ColName, Table table) :
+			public ExpandedColumnLink(MemberLink Ml, string ColName, Table table, IValueSerializer Serializer) :
 				base(Ml, null)
 			{
-				Links = LoadLinks(table, Ml.MemberType, ColName + ",");
+				Links = LoadLinks(table, Ml.MemberType, ColName + ",", Serializer);
 			}
 
 			public override void SaveField(object obj, IWriteRecord wr)
@@ -230,7 +245,7 @@ namespace EseLinq.Storage
 			}
 		}
 
-		protected static ColumnLink MakeColumnLink(Table table, MemberInfo mi, MemberLink ml, string Prefix)
+		protected static ColumnLink MakeColumnLink(Table table, MemberInfo mi, MemberLink ml, string Prefix, IValueSerializer Serializer)
 		{
 			Attribute ColNameAtt = Attribute.GetCustomAttribute(mi, typeof(ColumnNameAttribute));
 			string ColName;
@@ -240,15 +255,19 @@ namespace EseLinq.Storage
 				string.Concat(Prefix, mi.Name);
 
 			if(Attribute.GetCustomAttribute(mi, typeof(ExpandFieldAttribute)) != null)
-				return new ExpandedColumnLink(ml, ColName, table);
+				return new ExpandedColumnLink(ml, ColName, table, Serializer);
 
 			Column Col = new Column(table, ColName);
+			CompressedFieldAttribute Compressed = (CompressedFieldAttribute)Attribute.GetCustomAttribute(mi, typeof(CompressedFieldAttribute));
+
+			if(Compressed != null)
+				Col.CompressionThreshold = Compressed.MinSize;
 
 			if(Attribute.GetCustomAttribute(mi, typeof(FieldMultivaluedAttribute)) != null)
 				return new MultivaluedColumnLink(ml, Col, table);
 
 			if(Attribute.GetCustomAttribute(mi, typeof(BinaryFieldSerializationAttribute)) != null)
-				return new BinaryColumnLink(ml, Col);
+				return new BinaryColumnLink(ml, Col, Serializer);
 
 			if(Attribute.GetCustomAttribute(mi, typeof(XmlFieldSerializationAttribute)) != null)
 				return new XmlColumnLink(ml, Col);
@@ -257,17 +276,17 @@ namespace EseLinq.Storage
 		}
 
 		//creates linkages from metadata
-		protected static ColumnLink[] LoadLinks(Table table, Type ty, string Prefix)
+		protected static ColumnLink[] LoadLinks(Table table, Type ty, string Prefix, IValueSerializer Serializer)
 		{
 			List<ColumnLink > links = new List<ColumnLink >();
 
 			foreach(FieldInfo fi in ty.GetFields(BindingFlags.Public | BindingFlags.Instance))
 				if(null == Attribute.GetCustomAttribute(fi, typeof(NonpersistentAttribute))) //don't save if nonpersistent
-					links.Add(MakeColumnLink(table, fi, new FieldLink(fi), Prefix));
+					links.Add(MakeColumnLink(table, fi, new FieldLink(fi), Prefix, Serializer));
 
 			foreach(PropertyInfo pi in ty.GetProperties(BindingFlags.Public | BindingFlags.Instance))
 				if(null == Attribute.GetCustomAttribute(pi, typeof(NonpersistentAttribute))) //don't save if nonpersistent
-					links.Add(MakeColumnLink(table, pi, new PropertyLink(pi), Prefix));
+					links.Add(MakeColumnLink(table, pi, new PropertyLink(pi), Prefix, Serializer));
 
 			return links.ToArray();
 		}
@@ -275,9 +294,26 @@ namespace EseLinq.Storage
 
 		protected ColumnLink[] Links;
 
-		public Flat(Table table)			
+		public Flat(Table table) :
+			this(table, null)
+		{}
+
+		//shares the links of another instance
+		Flat(ColumnLink[] Links)
+		{
+			this.Links = Links;
+			Narrowed = true;
+		}
+
+		//true for instances from Narrow, which leave members uninitialized
+		internal readonly bool Narrowed;
+
+		///<summary>Uses the specified serializer for members with BinaryFieldSerializationAttribute. Null uses BinaryFormatter, as the other constructor does.
+		///<pr/>Data written with one serializer can only be read back with the same one.
+		///</summary>
+		public Flat(Table table, IValueSerializer Serializer)
 		{
-			Links = LoadLinks(table, typeof(T), string.Empty);
+			Links = LoadLinks(table, typeof(T), string.Empty, Serializer ?? new BinaryFormatterSerializer());
 		}
 
 		///<summary>Writes a single record using metadata associated with the object.</summary>
@@ -298,6 +334,65 @@ namespace EseLinq.Storage
 			return (T)(obj);
 		}
 
+		//members from expression trees can be reflected from a different type than the ones linked
+		static bool SameMember(MemberInfo a, MemberInfo b)
+		{
+			return a.MetadataToken == b.MetadataToken && a.Module == b.Module;
+		}
+
+		//column a member of T is stored in directly, so it can be compared in an index key
+		//null if the member isn't stored or is serialized, expanded or multivalued
+		internal Column ColumnFor(MemberInfo mi)
+		{
+			foreach(ColumnLink l in Links)
+				if(l.GetType() == typeof(ColumnLink) && SameMember(l.Ml.Mi, mi))
+					return l.Col;
+
+			return null;
+		}
+
+		//names of the columns Read retrieves, for Provider.Log
+		internal string ColumnNames()
+		{
+			var names = new List<string>();
+
+			AddColumnNames(Links, names);
+
+			return string.Join(", ", names.ToArray());
+		}
+
+		static void AddColumnNames(ColumnLink[] links, List<string> names)
+		{
+			foreach(ColumnLink l in links)
+			{
+				var expanded = l as ExpandedColumnLink;
+
+				if(expanded != null)
+					AddColumnNames(expanded.Links, names);
+				else
+					names.Add(l.Col.Name);
+			}
+		}
+
+		//instance that only reads the specified members, leaving the rest uninitialized, so their columns aren't retrieved
+		//null if any member isn't stored, since it could be computed from members that would be left out
+		internal Flat<T> Narrow(IEnumerable<MemberInfo> members)
+		{
+			List<ColumnLink> links = new List<ColumnLink>();
+
+			foreach(MemberInfo mi in members)
+			{
+				ColumnLink found = Array.Find(Links, l => SameMember(l.Ml.Mi, mi));
+
+				if(found == null)
+					return null;
+				if(!links.Contains(found))
+					links.Add(found);
+			}
+
+			return new Flat<T>(links.ToArray());
+		}
+
 		protected static void MakeColumnCreateOptions(ICollection<Column.CreateOptions> CreateOpts, MemberInfo mi, Type type, string Prefix, IDictionary<Type, Column.Type> TypeMap)
 		{
 			Attribute ColNameAtt = Attribute.GetCustomAttribute(mi, typeof(ColumnNameAttribute));
@@ -68,9 +68,7 @@ namespace EseLinq
 
 		public static IQueryable<T> AsQueryable<T>(this Table table, Provider provider)
 		{
-			Expression<Func<IQueryable<T>>> exp = () => table.AsEnumerable<T>().AsQueryable<T>();
-
-			return new Query<T>(provider, exp);
+			return new Query<T>(provider, new TableScan<T>(provider, table, new Flat<T>(table)));
 		}
 
 		/// <summary>
@@ -81,9 +79,7 @@ namespace EseLinq
 		/// <param name="provider">Instance of EseLinq provider.</param>
 		public static IQueryable<T> AsQueryable<T>(this Table table, Provider provider, IRecordBridge<T> bridge)
 		{
-			Expression<Func<IQueryable<T>>> exp = () => table.AsEnumerable<T>(bridge).AsQueryable<T>();
-
-			return new Query<T>(provider, exp);			
+			return new Query<T>(provider, new TableScan<T>(provider, table, bridge));
 		}
 	}
 
@@ -0,0 +1,541 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  TableScan
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+
+using EseObjects;
+using EseLinq.Storage;
+
+namespace EseLinq
+{
+	/// <summary>
+	/// Plan for reading the rows of a table a query needs: the index to read, the key range within it, the predicate left to check on each row and the order to return rows in.
+	/// Built up by Provider as it translates query operators. Each enumeration opens its own cursor.
+	/// Rows are only buffered to sort them when no index gives the order. Otherwise Skip moves the cursor past entries and Take stops reading.
+	/// </summary>
+	/// <typeparam name="T">Type to bridge rows into.</typeparam>
+	internal class TableScan<T> : IEnumerable, IEnumerable<T>, ITableScan
+	{
+		readonly Provider provider;
+		readonly Table table;
+		IRecordBridge<T> bridge;
+		//lambdas evaluated on each row, which need the members they read
+		List<LambdaExpression> uses;
+		//null for the primary index
+		Index index;
+		//null for the whole index
+		KeyRange range;
+		//checked on each row read; null if every row qualifies
+		Func<T, bool> residual;
+		//all predicates whole, checked instead of residual when the key range can't be made from the current values
+		Func<T, bool> predicate;
+		//sort keys from OrderBy and ThenBy, outermost first; null if unordered
+		List<SortKey<T>> order;
+		//true if reading index gives order, reading it backward if backward is set
+		bool indexed_order;
+		bool backward;
+		//Skip and Take applied after the predicates and order, in the order given; null if there are none
+		List<PageCount> pages;
+		//skipping at least this many entries is done by approximate position; 0 for never
+		int approximate_skip;
+
+		internal TableScan(Provider provider, Table table, IRecordBridge<T> bridge)
+		{
+			this.provider = provider;
+			this.table = table;
+			this.bridge = bridge;
+		}
+
+		/// <summary>
+		/// LINQ to Objects over the scan, for operators Provider doesn't translate.
+		/// Typed as ordered because Query exposes it as the source of ThenBy, which Provider always translates.
+		/// </summary>
+		public IOrderedQueryable<T> AsQueryable()
+		{
+			return (IOrderedQueryable<T>)Queryable.AsQueryable(this);
+		}
+
+		static Func<T, bool> And(Func<T, bool> a, Func<T, bool> b)
+		{
+			if(a == null)
+				return b;
+			if(b == null)
+				return a;
+
+			return row => a(row) && b(row);
+		}
+
+		/// <summary>
+		/// Scan of the rows that also match pred. Narrowed to a range of an index if pred compares key columns and no range was chosen already.
+		/// </summary>
+		internal TableScan<T> Where(Expression<Func<T, bool>> pred)
+		{
+			var scan = (TableScan<T>)MemberwiseClone();
+			var flat = bridge as Flat<T>;
+			Expression<Func<T, bool>> rest = pred;
+
+			if(range == null && flat != null)
+			{
+				//keep to the index giving the order, if any
+				IEnumerable<Index> indexes = indexed_order ? new Index[] {index} : table.Indexes;
+				Index ix;
+				KeyRange kr = IndexSelection.Choose(flat, indexes, pred, out ix, out rest);
+
+				if(kr != null)
+				{
+					scan.index = ix;
+					scan.range = kr;
+				}
+			}
+
+			scan.residual = And(residual, rest == null ? null : rest.Compile());
+			scan.predicate = And(predicate, pred.Compile());
+			scan.Use(pred);
+
+			//the range may let its index give the order
+			if(scan.order != null)
+				scan.Reorder();
+
+			return scan;
+		}
+
+		/// <summary>
+		/// True once Skip or Take is applied. Predicates and sort keys can't be added after that, since they would apply to the page.
+		/// </summary>
+		internal bool Paged
+		{
+			get
+			{
+				return pages != null;
+			}
+		}
+
+		/// <summary>
+		/// Scan of the rows after skipping count of them, or of only the first count, as Skip or Take.
+		/// </summary>
+		/// <param name="take">Take rather than Skip.</param>
+		/// <param name="count">Number of rows, which must not depend on the row. Evaluated each time the scan runs.</param>
+		/// <param name="approximate_skip">Skip counts at least this large position the cursor approximately, if the whole index is read and every row qualifies. 0 to always skip exactly.</param>
+		internal TableScan<T> Page(bool take, Expression count, int approximate_skip)
+		{
+			var scan = (TableScan<T>)MemberwiseClone();
+
+			scan.pages = pages == null ? new List<PageCount>() : new List<PageCount>(pages);
+			scan.pages.Add(new PageCount(take, count));
+
+			if(!take)
+				scan.approximate_skip = approximate_skip;
+
+			return scan;
+		}
+
+		//rows to skip, then at most how many to take, with the current counts; long.MaxValue for no limit
+		void PageBounds(out long skip, out long take)
+		{
+			skip = 0;
+			take = long.MaxValue;
+
+			if(pages == null)
+				return;
+
+			foreach(PageCount p in pages)
+			{
+				long n = p.Value;
+
+				if(p.Take)
+					take = Math.Min(take, n);
+				else
+				{
+					//skipping within an earlier Take shortens it
+					n = Math.Min(n, take);
+					skip += n;
+					if(take != long.MaxValue)
+						take -= n;
+				}
+			}
+		}
+
+		/// <summary>
+		/// Scan of the same rows sorted by key, or sorted further by it if then is set.
+		/// Reads an index in the order of the keys if there is one, otherwise rows are sorted after they're read.
+		/// </summary>
+		/// <param name="selector">Key selector.</param>
+		/// <param name="comparer">IComparer for the key type, or null for the default.</param>
+		/// <param name="descending">Sort descending.</param>
+		/// <param name="then">Sort by key within the current order, as ThenBy.</param>
+		internal TableScan<T> OrderBy(LambdaExpression selector, object comparer, bool descending, bool then)
+		{
+			var scan = (TableScan<T>)MemberwiseClone();
+			var flat = bridge as Flat<T>;
+			Column col = flat == null ? null : IndexSelection.OrderColumn(flat, selector);
+
+			scan.order = then && order != null ? new List<SortKey<T>>(order) : new List<SortKey<T>>();
+			scan.order.Add(new SortKey<T>(col, selector, comparer, descending));
+			scan.Use(selector);
+			scan.Reorder();
+
+			return scan;
+		}
+
+		void Use(LambdaExpression lambda)
+		{
+			uses = uses == null ? new List<LambdaExpression>() : new List<LambdaExpression>(uses);
+			uses.Add(lambda);
+		}
+
+		/// <summary>
+		/// LINQ to Objects projection of the scan. If rows are read by Flat, only the members the selector and the scan's predicates and sort keys read are retrieved.
+		/// </summary>
+		public IQueryable<TResult> Select<TResult>(Provider provider, LambdaExpression selector)
+		{
+			var sel = (Expression<Func<T, TResult>>)selector;
+			TableScan<T> scan = this;
+			IRecordBridge<T> reader = Reader(sel);
+
+			if(reader != bridge)
+			{
+				scan = (TableScan<T>)MemberwiseClone();
+				scan.bridge = reader;
+			}
+
+			Expression source = Expression.Call(Expression.Constant(scan), typeof(TableScan<T>).GetMethod("AsQueryable"));
+
+			return new Query<TResult>(provider, Expression.Lambda<Func<IQueryable<TResult>>>(
+				Expression.Call(typeof(Queryable), "Select", new Type[] {typeof(T), typeof(TResult)}, source, Expression.Quote(sel)), new ParameterExpression[0]));
+		}
+
+		//bridge that only reads the members used by the scan and by lambda, if any; bridge if every member is needed
+		IRecordBridge<T> Reader(LambdaExpression lambda)
+		{
+			var flat = bridge as Flat<T>;
+			var members = new List<MemberInfo>();
+
+			if(flat == null)
+				return bridge;
+			if(lambda != null && !RowMembers.Collect(lambda, members))
+				return bridge;
+			if(uses != null && !uses.TrueForAll(l => RowMembers.Collect(l, members)))
+				return bridge;
+
+			return flat.Narrow(members) ?? bridge;
+		}
+
+		//logs the columns reader retrieves, if it leaves any out
+		void LogColumns(IRecordBridge<T> reader)
+		{
+			var flat = reader as Flat<T>;
+
+			if(flat != null && flat.Narrowed)
+				provider.WriteLog("retrieve {0}", flat.ColumnNames());
+		}
+
+		/// <summary>
+		/// Number of rows the scan returns, and that also match predicate if it's not null, counting no more than limit.
+		/// If the key range of the index read answers every predicate, index entries are counted without reading rows.
+		/// Otherwise rows in the range are read to check them, retrieving only the members the predicates need.
+		/// </summary>
+		public long Count(LambdaExpression predicate, long limit)
+		{
+			//predicate applies to the page, so the page is read
+			if(predicate != null && Paged)
+			{
+				Func<T, bool> pred = ((Expression<Func<T, bool>>)predicate).Compile();
+				long ct = 0;
+
+				using(IEnumerator<T> rows = Rows().GetEnumerator())
+					while(ct < limit && rows.MoveNext())
+						if(pred(rows.Current))
+							ct++;
+
+				return ct;
+			}
+
+			var scan = (TableScan<T>)MemberwiseClone();
+
+			//order doesn't change the count, so it shouldn't keep the predicate from choosing another index
+			scan.order = null;
+			scan.indexed_order = false;
+
+			if(predicate != null)
+				scan = scan.Where((Expression<Func<T, bool>>)predicate);
+
+			return scan.Count(limit);
+		}
+
+		long Count(long limit)
+		{
+			using(var csr = new Cursor(table))
+			{
+				Func<T, bool> filter;
+				long ct = 0, read = 0, skip, take;
+
+				PageBounds(out skip, out take);
+				limit = Math.Min(limit, take);
+
+				if(limit <= 0 || !Position(csr, false, out filter))
+					return 0;
+				if(skip > 0 && !Skip(csr, false, filter, skip))
+					return 0;
+
+				if(filter == null)
+				{
+					provider.WriteLog("count entries");
+					return csr.ForwardRecordCount((uint)Math.Min(limit, uint.MaxValue));
+				}
+
+				IRecordBridge<T> reader = Reader(null);
+
+				LogColumns(reader);
+
+				for(bool any = true; any && ct < limit; any = csr.Move(1))
+				{
+					read++;
+					if(filter(reader.Read(csr)))
+						ct++;
+				}
+
+				provider.WriteLog("{0} rows read", read);
+
+				return ct;
+			}
+		}
+
+		//finds an index giving order; once there's a range only its index can
+		void Reorder()
+		{
+			if(range != null)
+				indexed_order = IndexSelection.MatchOrder(index, range, order, out backward);
+			else
+			{
+				//without a range, the index was only chosen for an earlier order, so sorted rows are read from the primary index
+				index = IndexSelection.ChooseOrder(table, order, out backward);
+				indexed_order = index != null;
+			}
+		}
+
+		IEnumerable<T> Rows()
+		{
+			if(order == null || indexed_order)
+				return Read(true);
+
+			IEnumerable<T> rows = Read(false);
+			IOrderedEnumerable<T> sorted = null;
+
+			provider.WriteLog("sort rows");
+
+			foreach(SortKey<T> sk in order)
+				sorted = sk.Apply(rows, sorted);
+
+			if(!Paged)
+				return sorted;
+
+			long skip, take;
+
+			PageBounds(out skip, out take);
+
+			return Window(sorted, skip, take);
+		}
+
+		//page of rows that had to be sorted first
+		IEnumerable<T> Window(IEnumerable<T> rows, long skip, long take)
+		{
+			long skipped = 0, taken = 0;
+
+			foreach(T row in rows)
+			{
+				if(taken == take)
+					yield break;
+
+				if(skipped < skip)
+					skipped++;
+				else
+				{
+					taken++;
+					yield return row;
+				}
+			}
+		}
+
+		//moves csr past the first count rows that qualify, to the next entry to read
+		//false if there are no more entries
+		bool Skip(Cursor csr, bool back, Func<T, bool> filter, long count)
+		{
+			int dir = back ? -1 : 1;
+
+			if(filter != null)
+			{
+				//each row has to be checked, but only the members the predicates use are read
+				IRecordBridge<T> reader = Reader(null);
+				long read = 0;
+
+				LogColumns(reader);
+
+				for(bool any = true; any; any = csr.Move(dir))
+				{
+					read++;
+					if(filter(reader.Read(csr)) && --count == 0)
+						break;
+				}
+
+				provider.WriteLog("skip rows, {0} read", read);
+
+				return count == 0 && csr.Move(dir);
+			}
+
+			if(range == null && approximate_skip > 0 && count >= approximate_skip)
+			{
+				provider.WriteLog("skip about {0} entries", count);
+
+				Cursor.RecordPosition pos = csr.ApproximatePosition;
+
+				if(count >= pos.EntriesTotal)
+					return false;
+
+				pos.EntriesLessThan = (uint)(back ? pos.EntriesTotal - 1 - count : count);
+				pos.EntriesInRange = 1;
+				csr.ApproximatePosition = pos;
+
+				return csr.HasCurrent;
+			}
+
+			provider.WriteLog("skip {0} entries", count);
+
+			//one move per entry skipped, walking the index without reading rows
+			while(count > 0)
+			{
+				int step = (int)Math.Min(count, int.MaxValue);
+
+				if(!csr.Move(dir * step))
+					return false;
+
+				count -= step;
+			}
+
+			return true;
+		}
+
+		//positions csr on the first entry to read in the scan's index and limits it to the key range
+		//filter is set to the predicate rows read still have to be checked with, or null if they all qualify
+		//false if there are no entries to read
+		bool Position(Cursor csr, bool back, out Func<T, bool> filter)
+		{
+			Seekable start = null;
+			Limitable end = null;
+			bool any;
+
+			filter = residual;
+
+			if(index != null)
+				csr.CurrentIndex = index;
+
+			if(range != null && (!range.TryMakeKeys(back, out start, out end) || range.LastChecked(back)))
+				filter = predicate;
+
+			provider.WriteLog("read {0}{1}{2}{3}", index == null ? "primary index" : "index " + index.IndexName, back ? " backward" : "", range == null ? "" : ": " + range, filter == null ? "" : "; checking rows");
+
+			if(back)
+			{
+				any = start != null ? csr.Seek(start) : csr.MoveLast();
+
+				if(any && end != null)
+					any = csr.SetLowerLimit(end);
+			}
+			else
+			{
+				any = start != null ? csr.Seek(start) : csr.MoveFirst();
+
+				if(any && end != null)
+					any = csr.SetUpperLimit(end);
+			}
+
+			return any;
+		}
+
+		//rows in index order, paged if page is set
+		IEnumerable<T> Read(bool page)
+		{
+			using(var csr = new Cursor(table))
+			{
+				bool back = indexed_order && backward;
+				long skip = 0, take = long.MaxValue;
+				Func<T, bool> filter;
+				bool any;
+
+				if(page)
+					PageBounds(out skip, out take);
+
+				any = Position(csr, back, out filter) && take > 0;
+
+				LogColumns(bridge);
+
+				if(any && skip > 0)
+					any = Skip(csr, back, filter, skip);
+
+				for(; any; any = csr.Move(back ? -1 : 1))
+				{
+					T row = bridge.Read(csr);
+
+					if(filter == null || filter(row))
+					{
+						yield return row;
+
+						if(--take == 0)
+							yield break;
+					}
+				}
+			}
+		}
+
+		IEnumerator<T> IEnumerable<T>.GetEnumerator()
+		{
+			return Rows().GetEnumerator();
+		}
+
+		IEnumerator IEnumerable.GetEnumerator()
+		{
+			return Rows().GetEnumerator();
+		}
+	}
+
+	/// <summary>
+	/// Operators on a TableScan that change the element type or return a value, for Provider to apply without knowing the row type.
+	/// </summary>
+	internal interface ITableScan
+	{
+		IQueryable<TResult> Select<TResult>(Provider provider, LambdaExpression selector);
+		long Count(LambdaExpression predicate, long limit);
+	}
+}
@@ -32,6 +32,11 @@
 ///<summary>Methods of conversion between database and .NET representations of data. Interface likely to change.</summary>
 public ref struct Bridge
 {
+	Bridge()
+	{
+		_Hooks = FindHooks(GetType());
+	}
+
 	static void ThrowConversionError()
 	{
 		throw gcnew InvalidOperationException("Data type conversion not defined");
@@ -103,6 +108,9 @@ public ref struct Bridge
 	///<param name="cp">Code page, needed for text types. Must be 1252 for ASCII or 1200 for Unicode when specifying a string object type.</param>
 	virtual Object ^ValueBytesToObject(Type ^type, bool isnull, IntPtr bytes, ulong size, Column::Type coltyp, ushort cp)
 	{
+		if(!isnull && Serializer != nullptr && IsSerializedType(type, static_cast<JET_COLTYP>(coltyp), cp))
+			return DeserializeValue(type, bytes, size);
+
 		bool success;
 		Object ^o = BuiltinValueBytesToObject(success, type, isnull, bytes, size, coltyp, cp);
 
@@ -150,6 +158,12 @@ public ref struct Bridge
 		return IntPtr::Zero;
 	}
 
+	///<summary>Serializer for values of serializable types without a builtin conversion. Null, the default, uses BinaryFormatter as EseObjects always has.</summary>
+	///<remarks>Data written with one serializer can only be read back with the same one, so changing this for a column with existing data requires rewriting that data.
+	///<pr/>CompactSerializer stores much smaller values and is faster, but requires the exact type when reading. Values set through a cursor are serialized as their runtime type, so they must be retrieved as that type.
+	///</remarks>
+	property IValueSerializer ^Serializer;
+
 	///<summary>Creates a single object T from an array of multiple values. Each value is retreived using ValueBytesToObject.</summary>
 	///<remarks>Default implementation returns the array of values</remarks>
 	generic <class T> virtual Object ^MultivalueToObject(array<Object ^> ^values)
@@ -192,6 +206,155 @@ public ref struct Bridge
 		ThrowConversionError(o->GetType(), array<Object ^>::typeid);
 		return nullptr;
 	}
+
+internal:
+	//conversion hooks overridden by a subclass
+	literal int HookToObject = 1; //ValueBytesToObject taking IntPtr
+	literal int HookToObjectArray = 2; //ValueBytesToObject taking a byte array
+	literal int HookFromObjectArray = 4; //ValueBytesFromObject returning a byte array
+	literal int HookFromObjectAllocator = 8; //ValueBytesFromObject taking an Allocator
+
+	int _Hooks;
+
+	//hooks found for each Bridge type, so reflection is only used the first time a type is constructed
+	static Dictionary<Type ^, int> ^_HooksByType = gcnew Dictionary<Type ^, int>();
+
+	static bool IsOverridden(Type ^t, String ^Name, array<Type ^> ^Params)
+	{
+		System::Reflection::MethodInfo ^m = t->GetMethod(Name, Params);
+
+		return m != nullptr && m->DeclaringType != Bridge::typeid;
+	}
+
+	static int FindHooks(Type ^t)
+	{
+		if(t == Bridge::typeid)
+			return 0;
+
+		int hooks;
+
+		System::Threading::Monitor::Enter(_HooksByType);
+		try
+		{
+			if(_HooksByType->TryGetValue(t, hooks))
+				return hooks;
+		}
+		finally
+		{
+			System::Threading::Monitor::Exit(_HooksByType);
+		}
+
+		Type ^ByRefBool = Boolean::typeid->MakeByRefType();
+
+		hooks = 0;
+
+		if(IsOverridden(t, "ValueBytesToObject", gcnew array<Type ^> {Type::typeid, Boolean::typeid, IntPtr::typeid, UInt32::typeid, Column::Type::typeid, UInt16::typeid}))
+			hooks |= HookToObject;
+		if(IsOverridden(t, "ValueBytesToObject", gcnew array<Type ^> {Type::typeid, Boolean::typeid, array<uchar>::typeid, Column::Type::typeid, UInt16::typeid}))
+			hooks |= HookToObjectArray;
+		if(IsOverridden(t, "ValueBytesFromObject", gcnew array<Type ^> {Object::typeid, ByRefBool, Column::Type::typeid, UInt16::typeid}))
+			hooks |= HookFromObjectArray;
+		if(IsOverridden(t, "ValueBytesFromObject", gcnew array<Type ^> {Object::typeid, ByRefBool, Column::Type::typeid, UInt16::typeid, Allocator::typeid, UInt32::typeid->MakeByRefType()}))
+			hooks |= HookFromObjectAllocator;
+
+		System::Threading::Monitor::Enter(_HooksByType);
+		try
+		{
+			_HooksByType[t] = hooks;
+		}
+		finally
+		{
+			System::Threading::Monitor::Exit(_HooksByType);
+		}
+
+		return hooks;
+	}
+
+	//true if no conversion hook is overridden, so callers may use the builtin conversions directly without going through the virtual methods
+	property bool IsDefault
+	{
+		bool get() {return _Hooks == 0;}
+	}
+
+	//true if values are read with the builtin conversions, only falling back to the byte array ValueBytesToObject when those fail
+	property bool BuiltinReads
+	{
+		bool get() {return !(_Hooks & HookToObject);}
+	}
+
+	//true if neither ValueBytesFromObject is overridden
+	property bool BuiltinWrites
+	{
+		bool get() {return !(_Hooks & (HookFromObjectArray | HookFromObjectAllocator));}
+	}
+
+	IValueSerializer ^SerializerOrDefault()
+	{
+		IValueSerializer ^s = Serializer;
+
+		return s != nullptr ? s : gcnew BinaryFormatterSerializer();
+	}
+
+	//serializable with no builtin conversion
+	static bool IsSerializedType(Type ^type, JET_COLTYP coltyp, ushort cp)
+	{
+		return type->IsSerializable && resolve_reader(type, coltyp, cp) == null;
+	}
+
+	Object ^DeserializeValue(Type ^type, IntPtr bytes, ulong size)
+	{
+		System::IO::Stream ^stream = size ?
+			gcnew System::IO::UnmanagedMemoryStream(static_cast<uchar *>(bytes.ToPointer()), size) :
+			gcnew System::IO::MemoryStream();
+
+		return SerializerOrDefault()->Deserialize(type, stream);
+	}
+
+	//ValueBytesToObject for a value of Col, expanding it first if it was compressed
+	Object ^ColumnValueToObject(Column ^Col, Type ^type, bool isnull, IntPtr bytes, ulong size)
+	{
+		array<uchar> ^expanded = isnull ? nullptr : Col->ExpandValue(bytes.ToPointer(), size);
+
+		if(expanded == nullptr)
+			return StoredValueToObject(Col, type, isnull, bytes, size);
+
+		if(type == array<uchar>::typeid && BuiltinReads)
+			return expanded;
+		if(expanded->Length == 0)
+			return StoredValueToObject(Col, type, false, IntPtr::Zero, 0);
+
+		pin_ptr<uchar> p = &expanded[0];
+
+		return StoredValueToObject(Col, type, false, IntPtr(p), expanded->Length);
+	}
+
+	//unless overridden, this is one call through the column's cached reader instead of the virtual method and type checks
+	Object ^StoredValueToObject(Column ^Col, Type ^type, bool isnull, IntPtr bytes, ulong size)
+	{
+		if(!BuiltinReads)
+			return ValueBytesToObject(type, isnull, bytes, size, Col->ColumnType, Col->_CP);
+
+		if(isnull)
+			return nullptr;
+
+		value_reader read = Col->ReaderFor(type);
+		bool success = false;
+
+		if(read)
+		{
+			Object ^o = read(success, bytes.ToPointer(), size, Col->_JetColTyp, Col->_CP);
+
+			if(success)
+				return o;
+		}
+		else if(type->IsSerializable)
+			return DeserializeValue(type, bytes, size);
+
+		//as the IntPtr ValueBytesToObject does when the builtin conversion fails
+		array<uchar> ^arr = gcnew array<uchar>(size);
+		System::Runtime::InteropServices::Marshal::Copy(bytes, arr, 0, size);
+		return ValueBytesToObject(type, isnull, arr, Col->ColumnType, Col->_CP);
+	}
 };
 
 Bridge ^GetDefaultBridge()
@@ -199,12 +362,12 @@ Bridge ^GetDefaultBridge()
 	return gcnew Bridge();
 }
 
-ref class FreeListAllocatorObj
+ref class RegionAllocatorObj
 {
-	free_list *fl;
+	region *fl;
 
 internal:
-	FreeListAllocatorObj(free_list *fl) :
+	RegionAllocatorObj(region *fl) :
 		fl(fl)
 	{}
 
@@ -214,28 +377,43 @@ internal:
 	}
 };
 
-void to_memblock_bridge(Bridge ^b, Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+//serializes with the Bridge's serializer, for serializable types without a builtin conversion
+void to_memblock_serialized(Bridge ^b, Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
-	Column::Type Coltyp = safe_cast<Column::Type>(coltyp);
+	System::IO::MemoryStream ^stream = gcnew System::IO::MemoryStream();
 
-	bool user_null = false;
-	array<uchar> ^user_array = b->ValueBytesFromObject(o, user_null, safe_cast<Column::Type>(coltyp), cp);
+	b->SerializerOrDefault()->Serialize(o->GetType(), o, stream); //no declared type here, so values must be retrieved as their exact type
+	to_memblock(stream->ToArray(), buff, max, empty, coltyp, cp, mc, fl);
+}
 
-	if(user_null)
-		goto exit_return_null;
+void to_memblock_bridge(Bridge ^b, Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
+{
+	Column::Type Coltyp = safe_cast<Column::Type>(coltyp);
 
-	//user byte array availaible
-	if(user_array != nullptr)
+	//the base class versions never supply a value, so only overridden hooks are called
+	if(b->_Hooks & Bridge::HookFromObjectArray)
 	{
-		to_memblock(user_array, buff, max, empty, coltyp, cp, mc, fl);
-		return;
+		bool user_null = false;
+		array<uchar> ^user_array = b->ValueBytesFromObject(o, user_null, safe_cast<Column::Type>(coltyp), cp);
+
+		if(user_null)
+			goto exit_return_null;
+
+		//user byte array availaible
+		if(user_array != nullptr)
+		{
+			to_memblock(user_array, buff, max, empty, coltyp, cp, mc, fl);
+			return;
+		}
 	}
 
 	//try user conversion for type
+	if(b->_Hooks & Bridge::HookFromObjectAllocator)
 	{
+		bool user_null = false;
 		ulong size = 0;
-		FreeListAllocatorObj ^flao = gcnew FreeListAllocatorObj(&fl);
-		Bridge::Allocator ^allocator = gcnew Bridge::Allocator(flao, &FreeListAllocatorObj::Allocate);
+		RegionAllocatorObj ^rao = gcnew RegionAllocatorObj(&fl);
+		Bridge::Allocator ^allocator = gcnew Bridge::Allocator(rao, &RegionAllocatorObj::Allocate);
 
 		buff = b->ValueBytesFromObject(o, user_null, Coltyp, cp, allocator, size).ToPointer();
 		max = size;
@@ -259,6 +437,12 @@ void to_memblock_bridge(Bridge ^b, Object ^o, void *&buff, ulong &max, bool &emp
 	if(o == nullptr)
 		goto exit_return_null;
 
+	if(b->Serializer != nullptr && o->GetType()->IsSerializable && resolve_writer(o->GetType()) == null)
+	{
+		to_memblock_serialized(b, o, buff, max, empty, coltyp, cp, mc, fl);
+		return;
+	}
+
 	if(!to_memblock(o, buff, max, empty, coltyp, cp, mc, fl))
 		Bridge::ThrowConversionError(Coltyp, o->GetType());
 
@@ -269,4 +453,27 @@ exit_return_null:
 		empty = false;
 		buff = null;
 		max = 0;
-}
\ No newline at end of file
+}
+
+//to_memblock_bridge for a value of Col
+//unless ValueBytesFromObject is overridden the column's cached writer is called directly
+void to_memblock_bridge(Bridge ^b, Column ^Col, Object ^o, void *&buff, ulong &max, bool &empty, marshal_context %mc, region &fl)
+{
+	if(!b->BuiltinWrites || o == nullptr)
+	{
+		to_memblock_bridge(b, o, buff, max, empty, Col->_JetColTyp, Col->_CP, mc, fl);
+		return;
+	}
+
+	value_writer write = Col->WriterFor(o->GetType());
+
+	if(write)
+	{
+		if(!write(o, buff, max, empty, Col->_JetColTyp, Col->_CP, mc, fl))
+			Bridge::ThrowConversionError(Col->ColumnType, o->GetType());
+	}
+	else if(o->GetType()->IsSerializable)
+		to_memblock_serialized(b, o, buff, max, empty, Col->_JetColTyp, Col->_CP, mc, fl);
+	else
+		Bridge::ThrowConversionError(Col->ColumnType, o->GetType());
+}
@@ -29,6 +29,33 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+//builtin conversion from column data to one type, cached by Column
+//replaced as a whole when another type is requested, so a reader never sees a type paired with the wrong function
+ref class CachedReader sealed
+{
+internal:
+	Type ^_Type;
+	value_reader _Read;
+
+	CachedReader(Type ^type, value_reader read) :
+		_Type(type),
+		_Read(read)
+	{}
+};
+
+//builtin conversion from values of one type to column data, cached by Column
+ref class CachedWriter sealed
+{
+internal:
+	Type ^_Type;
+	value_writer _Write;
+
+	CachedWriter(Type ^type, value_writer write) :
+		_Type(type),
+		_Write(write)
+	{}
+};
+
 ///<summary>
 ///Represents a single column in a table. Stores the name of the column (many ESE functions operate on only the column name) a JET_COLUMNID for fast selection and the properties of the column.
 ///Renaming the column will cause the name to go out of sync with other ESEObjects.Column objects. See RenameColumn for details.
@@ -40,6 +67,123 @@ internal:
 	JET_COLUMNID _JetColID;
 	JET_COLTYP _JetColTyp;
 	ushort _CP;
+	//largest value size seen by Cursor retrievals through this object, used to size the next retrieval buffer
+	ulong _SizeHint;
+	//conversions last used with the default Bridge, see ReaderFor and WriterFor
+	CachedReader ^_Reader;
+	CachedWriter ^_Writer;
+	//compression thresholds by column id, shared with the TableSchema of the table this was opened on so every Column object for the column agrees
+	//null for a Column not opened on a table, which keeps its own threshold in _CompressionThreshold
+	Dictionary<JET_COLUMNID, ulong> ^_Thresholds;
+	//see CompressionThreshold
+	ulong _CompressionThreshold;
+
+	ulong Threshold()
+	{
+		if(_Thresholds == nullptr)
+			return _CompressionThreshold;
+
+		ulong t;
+
+		return _Thresholds->Count && _Thresholds->TryGetValue(_JetColID, t) ? t : 0;
+	}
+
+	//builtin conversion to the requested type, resolved on first use and again only when a different type is requested
+	//null if there is no builtin conversion
+	value_reader ReaderFor(Type ^type)
+	{
+		CachedReader ^c = _Reader;
+
+		if(c == nullptr || c->_Type != type)
+			_Reader = c = gcnew CachedReader(type, resolve_reader(type, _JetColTyp, _CP));
+
+		return c->_Read;
+	}
+
+	//builtin conversion from values of the specified type, cached the same way
+	value_writer WriterFor(Type ^type)
+	{
+		CachedWriter ^c = _Writer;
+
+		if(c == nullptr || c->_Type != type)
+			_Writer = c = gcnew CachedWriter(type, resolve_writer(type));
+
+		return c->_Write;
+	}
+
+	bool IsLongValue()
+	{
+		return _JetColTyp == JET_coltypLongText || _JetColTyp == JET_coltypLongBinary;
+	}
+
+	//frames a long value being written through this object if compression is enabled, see lz.hpp for the format
+	//compressed if it's at least CompressionThreshold bytes and gets smaller; otherwise stored as is unless it would read as a framed value
+	void CompressValue(void *&buff, ulong &max, region &fl)
+	{
+		if(!IsLongValue())
+			return;
+
+		ulong threshold = Threshold();
+
+		if(!threshold)
+			return;
+
+		if(max >= threshold)
+		{
+			void *dest = fl.alloc_bytes(max);
+			size_t sz = lz_frame(buff, max, dest);
+
+			if(sz)
+			{
+				buff = dest;
+				max = static_cast<ulong>(sz);
+				return;
+			}
+		}
+
+		if(lz_framed(buff, max))
+		{
+			void *dest = fl.alloc_bytes(max + LZ_STORED_HEADER);
+
+			lz_frame_stored(buff, max, dest);
+			buff = dest;
+			max += LZ_STORED_HEADER;
+		}
+	}
+
+	//expanded copy of a framed long value read from this column, if compression is enabled
+	//null if the value isn't framed, or doesn't expand, as with a partial retrieval; the caller then uses the bytes as stored
+	array<uchar> ^ExpandValue(void const *bytes, ulong size)
+	{
+		size_t out_ct;
+
+		if(!IsLongValue() || !Threshold() || !lz_framed(bytes, size) || !lz_frame_length(bytes, size, out_ct))
+			return nullptr;
+
+		array<uchar> ^arr = gcnew array<uchar>(static_cast<int>(out_ct));
+
+		if(out_ct == 0)
+			return arr;
+
+		pin_ptr<uchar> dest = &arr[0];
+
+		if(!lz_unframe(bytes, size, dest, out_ct))
+			return nullptr;
+
+		return arr;
+	}
+
+	//as ExpandValue for a value already retrieved into an array, returning the array itself if it isn't framed
+	array<uchar> ^ExpandBytes(array<uchar> ^arr)
+	{
+		if(arr->Length == 0)
+			return arr;
+
+		pin_ptr<uchar> src = &arr[0];
+		array<uchar> ^expanded = ExpandValue(src, arr->Length);
+
+		return expanded != nullptr ? expanded : arr;
+	}
 
 private:
 	String ^_ColumnName;
@@ -88,6 +232,7 @@ private:
 		_Collate = jcd.wCollate;
 		_MaxLength = jcd.cbMax;
 		_Flags = jcd.grbit;
+		_Reader = nullptr; //the default type depends on the column type
 	}
 
 internal:
@@ -239,17 +384,13 @@ internal:
 		return b;
 	}
 
-public:
-	///<summary>Opens the specified column. Calls JetGetTableColumnInfo.</summary>
-	Column(Table ^Table, String ^Name) :
-		_JetColID(null),
-		_ColumnName(Name)
+	//fills in this column's properties from the table by its name
+	void Open(JET_SESID sesid, JET_TABLEID tableid)
 	{
 		marshal_context mc;
-		char const *NameStr = mc.marshal_as<char const *>(Name);
+		String ^LocalNameHandle = _ColumnName;
+		char const *NameStr = mc.marshal_as<char const *>(LocalNameHandle);
 		JET_COLUMNDEF jcd = {sizeof jcd};
-		JET_TABLEID tableid = GetTableTableID(Table);
-		JET_SESID sesid = GetTableSesid(Table);
 
 		EseException::RaiseOnError(JetGetTableColumnInfo(sesid, tableid, NameStr, &jcd, sizeof jcd, JET_ColInfo));
 
@@ -261,25 +402,31 @@ public:
 		_BaseColumnName = marshal_as<String ^>(jcb.szBaseColumnName);
 	}
 
-	///<summary>Opens the specified column. Calls JetGetTableColumnInfo.</summary>
-	Column(Cursor ^Csr, String ^Name) :
+internal:
+	Column(JET_SESID sesid, JET_TABLEID tableid, String ^Name) :
 		_JetColID(null),
 		_ColumnName(Name)
 	{
-		marshal_context mc;
-		char const *NameStr = mc.marshal_as<char const *>(Name);
-		JET_COLUMNDEF jcd = {sizeof jcd};
-		JET_TABLEID tableid = GetCursorTableID(Csr);
-		JET_SESID sesid = GetCursorSesid(Csr);
-
-		EseException::RaiseOnError(JetGetTableColumnInfo(sesid, tableid, NameStr, &jcd, sizeof jcd, JET_ColInfo));
-
-		SetFieldsFromColumnDef(jcd);
+		Open(sesid, tableid);
+	}
 
-		JET_COLUMNBASE jcb(GetColBase(sesid, tableid));
+public:
+	///<summary>Opens the specified column. Calls JetGetTableColumnInfo.</summary>
+	Column(Table ^Table, String ^Name) :
+		_JetColID(null),
+		_Thresholds(GetTableThresholds(GetTableIDObj(Table))),
+		_ColumnName(Name)
+	{
+		Open(GetTableSesid(Table), GetTableTableID(Table));
+	}
 
-		_BaseTableName = marshal_as<String ^>(jcb.szBaseTableName);
-		_BaseColumnName = marshal_as<String ^>(jcb.szBaseColumnName);
+	///<summary>Opens the specified column. Calls JetGetTableColumnInfo.</summary>
+	Column(Cursor ^Csr, String ^Name) :
+		_JetColID(null),
+		_Thresholds(GetTableThresholds(GetCursorTableIDObj(Csr))),
+		_ColumnName(Name)
+	{
+		Open(GetCursorSesid(Csr), GetCursorTableID(Csr));
 	}
 
 	///<summary>Creates a new column in the specified table. Calls JetAddColumn.</summary>
@@ -301,8 +448,11 @@ public:
 		
 		EseException::RaiseOnError(JetAddColumn(sesid, tableid, NameStr, &jcd, null, 0, &newcolid));
 
+		InvalidateTableSchema(Table);
+
 		Column ^ret = gcnew Column(newcolid, Parameters.Name);
 
+		ret->_Thresholds = GetTableThresholds(GetTableIDObj(Table));
 		ret->_JetColTyp = jcd.coltyp;
 		ret->_Country = jcd.wCountry;
 		ret->_Langid = jcd.langid;
@@ -325,6 +475,8 @@ public:
 		char const *ColNameStr = mc.marshal_as<char const *>(ColNameHandleCopy);
 
 		EseException::RaiseOnError(JetDeleteColumn(sesid, tableid, ColNameStr));
+
+		InvalidateTableSchema(SrcTable);
 	}
 
 	///<summary>
@@ -348,6 +500,8 @@ public:
 
 		EseException::RaiseOnError(JetRenameColumn(sesid, tableid, OldColNameStr, NewColNameStr, 0));
 
+		InvalidateTableSchema(SrcTable);
+
 		_ColumnName = NewName;
 	}
 
@@ -389,6 +543,27 @@ public:
 
 	///<summary>For a derived table, the base column this column is derived from.</summary>
 	property String ^BaseColumnName {String ^get() {return _BaseColumnName;}}
+
+	///<summary>LongText and LongBinary values at least this many bytes long are compressed when written through a Cursor with this Column object. 0, the default, disables compression.</summary>
+	///<remarks>Values are only stored compressed when that makes them smaller. While this is set, every value written through the column starts with a header, and values read from it are expanded according to that header.
+	///<pr/>With 0, values are written and read exactly as they are, as they always have been, so columns that never enable compression are not affected.
+	///<pr/>Kept per column in the schema cache of the Database object the table was opened through, so it applies to every Column object for the column from that Database, including those used for access by name, RetrieveAllFields and ColumnMap. It survives rollbacks and is dropped when the table is deleted.
+	///<pr/>Not saved in the database; set it in each Database object used to read or write the column, including before its first value is written. Values written before compression was enabled are not framed and can be misread once it is.
+	///<pr/>Long value streams, partial retrievals, updates at an offset and RecordBatch work on the stored bytes, so they shouldn't be used with compressed values.
+	///</remarks>
+	property ulong CompressionThreshold
+	{
+		ulong get() {return Threshold();}
+		void set(ulong value)
+		{
+			if(_Thresholds == nullptr)
+				_CompressionThreshold = value;
+			else if(value)
+				_Thresholds[_JetColID] = value;
+			else
+				_Thresholds->Remove(_JetColID);
+		}
+	}
 };
 
 SortedList<JET_COLUMNID, Column ^> ^QueryTableColumns(JET_SESID JetSesid, JET_TABLEID SrcJetTableID)
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  EseObjects.ColumnSet - Preresolved group of columns for batched retrieval
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//largest buffer preallocated for a single column in a batched retrieval
+//values larger than this are retrieved again after the batch reports truncation
+size_t const ESEOBJECTS_MAX_PRESIZE = 1024;
+
+///<summary>
+///An ordered group of columns and the types to retrieve them as, for use with Cursor.RetrieveColumns.
+///Buffer sizes for each column are computed once on construction, so reusing a ColumnSet across rows avoids repeating that work.
+///There are no disposable resources associated with an instance of this class.
+///</summary>
+public ref class ColumnSet
+{
+internal:
+	array<Column ^> ^_Columns;
+	array<Type ^> ^_Types;
+	array<ulong> ^_BufferSizes;
+	ulong _TotalBufferSize;
+
+	//initial buffer size from the column definition
+	//fixed columns report their exact size in cbMax; unbounded or very large columns start small and are refetched if needed
+	static ulong InitialBufferSize(Column ^Col)
+	{
+		ulong sz = Col->MaxLength;
+
+		if(sz == 0)
+			return ESEOBJECTS_MAX_ALLOCA;
+		if(sz > ESEOBJECTS_MAX_PRESIZE)
+			return ESEOBJECTS_MAX_PRESIZE;
+		return sz;
+	}
+
+	void Init(array<Column ^> ^Columns, array<Type ^> ^Types)
+	{
+		if(Columns == nullptr)
+			throw gcnew ArgumentNullException("Columns");
+		if(Types == nullptr)
+			throw gcnew ArgumentNullException("Types");
+		if(Columns->Length != Types->Length)
+			throw gcnew ArgumentException("Columns and Types must have the same number of elements");
+
+		_Columns = safe_cast<array<Column ^> ^>(Columns->Clone());
+		_Types = safe_cast<array<Type ^> ^>(Types->Clone());
+		_BufferSizes = gcnew array<ulong>(_Columns->Length);
+		_TotalBufferSize = 0;
+
+		for(int i = 0; i < _Columns->Length; i++)
+		{
+			if(_Columns[i] == nullptr)
+				throw gcnew ArgumentNullException("Columns");
+			if(_Types[i] == nullptr)
+				_Types[i] = Object::typeid;
+
+			_BufferSizes[i] = InitialBufferSize(_Columns[i]);
+			_TotalBufferSize += _BufferSizes[i];
+		}
+	}
+
+public:
+	///<summary>Builds a set from the specified columns and the types to retrieve each as. Types must be supported by the current Bridge of the cursor used.</summary>
+	ColumnSet(array<Column ^> ^Columns, array<Type ^> ^Types)
+	{
+		Init(Columns, Types);
+	}
+
+	///<summary>Builds a set from the specified columns, retrieving each as the default type for the column type.</summary>
+	ColumnSet(array<Column ^> ^Columns)
+	{
+		Init(Columns, gcnew array<Type ^>(Columns == nullptr ? 0 : Columns->Length));
+	}
+
+	///<summary>Number of columns in the set.</summary>
+	property int Count {int get() {return _Columns->Length;}}
+
+	///<summary>Column at the specified position in the set.</summary>
+	property Column ^default[int]
+	{
+		Column ^get(int Index) {return _Columns[Index];}
+	}
+
+	///<summary>Type used to retrieve the column at the specified position in the set.</summary>
+	Type ^TypeAt(int Index)
+	{
+		return _Types[Index];
+	}
+};
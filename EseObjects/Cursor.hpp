@@ -38,18 +38,24 @@ public ref class Cursor sealed : IReadRecord
 {
 	TableID ^_TableID;
 	Index ^_CurrentIndex;
+	scratch_buffer *_Scratch; //reused by Retrieve, allocated on first use
+	bool _ScratchBusy; //set while a Bridge conversion is reading from _Scratch
 
 internal:
 	Cursor(TableID ^TableID) :
 		_TableID(TableID),
-		_CurrentIndex(nullptr)
+		_CurrentIndex(nullptr),
+		_Scratch(null),
+		_ScratchBusy(false)
 	{}
 
 public:
 	///<summary>Opens a new cursor for the corresponding table. Inherits OpenOptions flags used when opening that table originally. Calls JetDupCursor.</summary>
 	Cursor(Table ^SrcTable) :
 		_TableID(GetTableIDObj(SrcTable)->Duplicate()),
-		_CurrentIndex(nullptr)
+		_CurrentIndex(nullptr),
+		_Scratch(null),
+		_ScratchBusy(false)
 	{}
 
 	///<summary>
@@ -60,13 +66,17 @@ public:
 	///</summary>
 	Cursor(Cursor ^SrcCursor) :
 		_TableID(SrcCursor->_TableID->Duplicate()),
-		_CurrentIndex(nullptr)
+		_CurrentIndex(nullptr),
+		_Scratch(null),
+		_ScratchBusy(false)
 	{}
 
 	///<summary>Opens an existing table with default options. Lifetime is tied to associated database's session.</summary>
 	Cursor(Database ^Db, String ^TableName) :
 		_TableID(nullptr),
-		_CurrentIndex(nullptr)
+		_CurrentIndex(nullptr),
+		_Scratch(null),
+		_ScratchBusy(false)
 	{
 		marshal_context mc;
 		char const *NameChar = mc.marshal_as<char const *>(TableName);
@@ -81,6 +91,13 @@ public:
 	~Cursor()
 	{
 		_TableID->~TableID();
+		this->!Cursor();
+	}
+
+	!Cursor()
+	{
+		delete _Scratch;
+		_Scratch = null;
 	}
 
 	///<summary>Duplicates the current JET_TABLEID and returns a new Table object.</summary>
@@ -179,24 +196,60 @@ public:
 
 //---------------------------Field retrieval support methods-------------------
 internal:
-	Object ^Retrieve(Type ^type, JET_COLUMNID colid, JET_COLTYP coltyp, ushort cp, JET_GRBIT flags, ulong size_hint, ulong size_limit, ulong RetrieveOffsetLV, ulong RetrieveTagSequence)
+	//retrieves a value of known size into a new array with no intermediate copy
+	array<uchar> ^RetrieveBytesDirect(JET_COLUMNID colid, JET_GRBIT flags, ulong size, JET_RETINFO ret_info)
 	{
-		free_list fl;
-		void *buff;
+		array<uchar> ^arr = gcnew array<uchar>(size);
 
-		if(size_hint <= ESEOBJECTS_MAX_ALLOCA) //small enough to allocate on stack for speed
-			buff = alloca_array(char, size_hint);
-		else
-			fl.alloc_array<char>(size_hint);
+		if(size == 0)
+			return arr;
+
+		ulong actual = 0;
+		JET_ERR status;
+
+		{
+			pin_ptr<uchar> dest = &arr[0];
+
+			status = JetRetrieveColumn(Session->_JetSesid, _TableID->_JetTableID, colid, dest, size, &actual, flags, &ret_info);
+		}
+
+		if(status != JET_wrnBufferTruncated) //truncation is expected if stopping at size_limit
+			EseException::RaiseOnError(status);
+
+		if(actual < size)
+			Array::Resize<uchar>(arr, actual);
 
+		return arr;
+	}
+
+	//SizeHint is the caller's estimate of the value size and is updated with the actual size retrieved, so passing a Column's _SizeHint lets later calls size the buffer correctly the first time
+	Object ^RetrieveValue(Type ^type, Column ^Col, JET_GRBIT flags, ulong %SizeHint, ulong size_limit, ulong RetrieveOffsetLV, ulong RetrieveTagSequence)
+	{
+		JET_COLUMNID colid = Col->_JetColID;
+		region fl;
+		void *buff;
 		ulong buffsz;
-		ulong req_buffsz = 0;
+		bool use_scratch = !_ScratchBusy; //a Bridge conversion could reenter on this cursor while the scratch buffer is being read
+
+		if(use_scratch)
+		{
+			if(!_Scratch)
+				_Scratch = new scratch_buffer;
 
-		if(size_limit)
-			req_buffsz = min(size_hint, size_limit);
+			//use all of the scratch buffer, since it's already allocated
+			buff = _Scratch->reserve(SizeHint);
+			buffsz = static_cast<ulong>(_Scratch->size());
+		}
 		else
-			buffsz = size_hint;
+		{
+			buffsz = max(SizeHint, static_cast<ulong>(ESEOBJECTS_MAX_ALLOCA));
+			buff = fl.alloc_array<char>(buffsz);
+		}
+
+		if(size_limit && buffsz > size_limit)
+			buffsz = size_limit;
 
+		ulong req_buffsz = 0;
 		JET_RETINFO ret_info = {sizeof ret_info};
 
 		ret_info.ibLongValue = RetrieveOffsetLV;
@@ -216,32 +269,71 @@ internal:
 		case JET_wrnBufferTruncated:
 		case JET_errBufferTooSmall:
 			//can only request up to size limit
-			if(size_limit)
+			if(size_limit && buffsz == size_limit)
 			{
-				//already at limit?
-				if(buffsz == size_limit) 
-					break; //already retreived full request
-				//still more space to limit, get as much as possible
-				req_buffsz = min(req_buffsz, size_limit);
+				req_buffsz = buffsz; //already retreived full request
+				break;
 			}
+
+			if(size_limit)
+				req_buffsz = min(req_buffsz, size_limit);
+
+			//with the size now known, a byte array for the builtin conversion is retrieved straight into the result
+			//this also keeps large blobs from growing the scratch buffer
+			if(type == array<uchar>::typeid && Bridge->BuiltinReads)
+				return Col->ExpandBytes(RetrieveBytesDirect(colid, flags, req_buffsz, ret_info));
+
 			//buffer needs to be bigger
-			buff = fl.alloc_array<char>(req_buffsz);
+			if(use_scratch)
+				buff = _Scratch->reserve(req_buffsz);
+			else
+				buff = fl.alloc_array<char>(req_buffsz);
 			buffsz = req_buffsz;
 
 			//this call shouldn't fail in a way we could have fixed here (i.e. buffer too small)
-			EseException::RaiseOnError(JetRetrieveColumn(Session->_JetSesid, _TableID->_JetTableID, colid, buff, buffsz, &req_buffsz, flags, &ret_info));
+			status = JetRetrieveColumn(Session->_JetSesid, _TableID->_JetTableID, colid, buff, buffsz, &req_buffsz, flags, &ret_info);
+			if(status != JET_wrnBufferTruncated) //truncation is expected if stopping at size_limit
+				EseException::RaiseOnError(status);
+			req_buffsz = min(req_buffsz, buffsz);
 			break;
 
 		case JET_wrnColumnNull:
-			return Bridge->ValueBytesToObject(type, true, IntPtr(0), 0, safe_cast<Column::Type>(coltyp), cp);
-			
+			return Bridge->ColumnValueToObject(Col, type, true, IntPtr(0), 0);
+
 		default:
 			//if it was some other error, raise it
 			EseException::RaiseOnError(status);
 			break;
 		}
 
-		return Bridge->ValueBytesToObject(type, false, IntPtr(buff), req_buffsz, safe_cast<Column::Type>(coltyp), cp);
+		if(req_buffsz > SizeHint)
+			SizeHint = min(req_buffsz, static_cast<ulong>(ESEOBJECTS_MAX_SCRATCH_RETAIN));
+
+		if(!use_scratch)
+			return Bridge->ColumnValueToObject(Col, type, false, IntPtr(buff), req_buffsz);
+
+		_ScratchBusy = true;
+		try
+		{
+			return Bridge->ColumnValueToObject(Col, type, false, IntPtr(buff), req_buffsz);
+		}
+		finally
+		{
+			_ScratchBusy = false;
+			_Scratch->trim(ESEOBJECTS_MAX_SCRATCH_RETAIN);
+		}
+	}
+
+	Object ^Retrieve(Type ^type, Column ^Col, JET_GRBIT flags, ulong size_hint, ulong size_limit, ulong RetrieveOffsetLV, ulong RetrieveTagSequence)
+	{
+		//learned size only applies to whole values
+		if(RetrieveOffsetLV || size_limit)
+			return RetrieveValue(type, Col, flags, size_hint, size_limit, RetrieveOffsetLV, RetrieveTagSequence);
+
+		if(Col->_SizeHint < size_hint)
+			Col->_SizeHint = size_hint;
+
+		return RetrieveValue(type, Col, flags, Col->_SizeHint, size_limit, RetrieveOffsetLV, RetrieveTagSequence);
 	}
 
 public:
@@ -253,7 +345,7 @@ public:
 	{
 		JET_GRBIT flags = RetrieveOptionsFlagsToBits(ro);
 
-		return safe_cast<T>(Retrieve(T::typeid, Col->_JetColID, Col->_JetColTyp, Col->_CP, flags, ro.SizeHint, ro.SizeLimit, ro.RetrieveOffsetLV, ro.RetrieveTagSequence));
+		return safe_cast<T>(Retrieve(T::typeid, Col, flags, ro.SizeHint, ro.SizeLimit, ro.RetrieveOffsetLV, ro.RetrieveTagSequence));
 	}
 
 	///<summary>Retrieves the data from the specificd column at the current cursor position. Calls JetRetrieveColumn.
@@ -261,7 +353,7 @@ public:
 	///</summary>
 	generic <class T> virtual T Retrieve(Column ^Col)
 	{
-		return safe_cast<T>(Retrieve(T::typeid, Col->_JetColID, Col->_JetColTyp, Col->_CP, 0, ESEOBJECTS_MAX_ALLOCA, 0, 0, 1));
+		return safe_cast<T>(Retrieve(T::typeid, Col, 0, ESEOBJECTS_MAX_ALLOCA, 0, 0, 1));
 	}
 
 	///<summary>Retrieves the data from the specificd column at the current cursor position. Calls JetRetrieveColumn.
@@ -272,7 +364,7 @@ public:
 	{
 		JET_GRBIT flags = RetrieveOptionsFlagsToBits(ro);
 
-		return Retrieve(Type, Col->_JetColID, Col->_JetColTyp, Col->_CP, flags, ro.SizeHint, ro.SizeLimit, ro.RetrieveOffsetLV, ro.RetrieveTagSequence);
+		return Retrieve(Type, Col, flags, ro.SizeHint, ro.SizeLimit, ro.RetrieveOffsetLV, ro.RetrieveTagSequence);
 	}
 
 	///<summary>Retrieves the data from the specificd column at the current cursor position. Calls JetRetrieveColumn.
@@ -280,68 +372,52 @@ public:
 	///</summary>
 	virtual Object ^Retrieve(Column ^Col, Type ^Type)
 	{
-		return Retrieve(Type, Col->_JetColID, Col->_JetColTyp, Col->_CP, 0, ESEOBJECTS_MAX_ALLOCA, 0, 0, 1);
+		return Retrieve(Type, Col, 0, ESEOBJECTS_MAX_ALLOCA, 0, 0, 1);
 	}
 
 internal:
-	JET_COLUMNDEF LookupColumnDef(String ^Name)
+	Column ^LookupColumn(String ^Name)
 	{
-		marshal_context mc;
-		char const *NameStr = mc.marshal_as<char const *>(Name);
-		JET_COLUMNDEF jcd = {sizeof jcd};
-
-		EseException::RaiseOnError(JetGetTableColumnInfo(_TableID->Session->_JetSesid, _TableID->_JetTableID, NameStr, &jcd, sizeof jcd, JET_ColInfo));
-
-		return jcd;
+		return TableSchema::ForTableID(_TableID)->LookupColumn(_TableID->Session->_JetSesid, _TableID->_JetTableID, Name);
 	}
 
 public:
-	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetGetTableColumnInfo and JetRetrieveColumn.
-	///Less efficient than using a Column object to identify the column.
+	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetRetrieveColumn.
+	///The name is resolved through a schema cache shared by the table, calling JetGetTableColumnInfo only the first time each name is used.
 	///Uses the specified retrieval options.
 	///The type parameter determines the type of the return value. Type must be supported by current Bridge. Use Object to retrieve the default type based on the column type.
 	///</summary>
 	generic <class T> virtual T Retrieve(String ^Col, IReadRecord::RetrieveOptions ro)
 	{
-		JET_GRBIT flags = RetrieveOptionsFlagsToBits(ro);
-		JET_COLUMNDEF jcd = LookupColumnDef(Col);
-
-		return safe_cast<T>(Retrieve(T::typeid, jcd.columnid, jcd.coltyp, jcd.cp, flags, ro.SizeHint, ro.SizeLimit, ro.RetrieveOffsetLV, ro.RetrieveTagSequence));
+		return Retrieve<T>(LookupColumn(Col), ro);
 	}
 
-	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetGetTableColumnInfo and JetRetrieveColumn.
-	///Less efficient than using a Column object to identify the column.
+	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetRetrieveColumn.
+	///The name is resolved through a schema cache shared by the table, calling JetGetTableColumnInfo only the first time each name is used.
 	///The type parameter determines the type of the return value. Type must be supported by current Bridge. Use Object to retrieve the default type based on the column type.
 	///</summary>
 	generic <class T> virtual T Retrieve(String ^Col)
 	{
-		JET_COLUMNDEF jcd = LookupColumnDef(Col);
-
-		return safe_cast<T>(Retrieve(T::typeid, jcd.columnid, jcd.coltyp, jcd.cp, 0, ESEOBJECTS_MAX_ALLOCA, 0, 0, 1));
+		return Retrieve<T>(LookupColumn(Col));
 	}
 
-	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetGetTableColumnInfo and JetRetrieveColumn.
-	///Less efficient than using a Column object to identify the column.
+	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetRetrieveColumn.
+	///The name is resolved through a schema cache shared by the table, calling JetGetTableColumnInfo only the first time each name is used.
 	///Uses the specified retrieval options.
 	///The type parameter determines the type of the return value. Type must be supported by current Bridge. Use Object to retrieve the default type based on the column type.
 	///</summary>
 	virtual Object ^Retrieve(String ^Col, Type ^Type, IReadRecord::RetrieveOptions ro)
 	{
-		JET_GRBIT flags = RetrieveOptionsFlagsToBits(ro);
-		JET_COLUMNDEF jcd = LookupColumnDef(Col);
-
-		return Retrieve(Type, jcd.columnid, jcd.coltyp, jcd.cp, flags, ro.SizeHint, ro.SizeLimit, ro.RetrieveOffsetLV, ro.RetrieveTagSequence);
+		return Retrieve(LookupColumn(Col), Type, ro);
 	}
 
-	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetGetTableColumnInfo and JetRetrieveColumn.
-	///Less efficient than using a Column object to identify the column.
+	///<summary>Retrieves the data from the specificd column by name at the current cursor position. Calls JetRetrieveColumn.
+	///The name is resolved through a schema cache shared by the table, calling JetGetTableColumnInfo only the first time each name is used.
 	///The type parameter determines the type of the return value. Type must be supported by current Bridge. Use Object to retrieve the default type based on the column type.
 	///</summary>
 	virtual Object ^Retrieve(String ^Col, Type ^Type)
 	{
-		JET_COLUMNDEF jcd = LookupColumnDef(Col);	
-
-		return Retrieve(Type, jcd.columnid, jcd.coltyp, jcd.cp, 0, ESEOBJECTS_MAX_ALLOCA, 0, 0, 1);
+		return Retrieve(LookupColumn(Col), Type);
 	}
 
 	///<summary>Retrieves a value by Column with Retrieve&lt;Object ^&gt;(Col)</summary>
@@ -356,6 +432,229 @@ public:
         Object ^get(String ^Col) { return Retrieve<Object ^>(Col); }
     }
 
+internal:
+	//retrieves a fixed size value directly into T with the builtin conversions, avoiding a boxed intermediate when the default Bridge is in effect
+	template <class T> T RetrieveScalar(Column ^Col, bool %IsNull)
+	{
+		if(!Bridge->IsDefault)
+		{
+			Object ^o = Retrieve(T::typeid, Col, 0, ESEOBJECTS_MAX_ALLOCA, 0, 0, 1);
+
+			IsNull = o == nullptr;
+			return IsNull ? T() : safe_cast<T>(o);
+		}
+
+		uchar buff[16]; //large enough for any fixed size column type (GUID is largest)
+		ulong actual = 0;
+
+		JET_ERR status = JetRetrieveColumn(Session->_JetSesid, _TableID->_JetTableID, Col->_JetColID, buff, sizeof buff, &actual, 0, null);
+
+		switch(status)
+		{
+		case JET_errSuccess:
+			break;
+
+		case JET_wrnBufferTruncated:
+			//scalar conversions only use a prefix of the data
+			actual = sizeof buff;
+			break;
+
+		case JET_wrnColumnNull:
+			IsNull = true;
+			return T();
+
+		default:
+			EseException::RaiseOnError(status);
+			break;
+		}
+
+		bool success = false;
+		T value = from_memblock<T>(success, buff, actual, Col->_JetColTyp, Col->_CP);
+
+		if(!success)
+			EseObjects::Bridge::ThrowConversionError(Col->ColumnType, T::typeid);
+
+		IsNull = false;
+		return value;
+	}
+
+public:
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Boolean. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case false is returned.</param>
+	Boolean RetrieveBoolean(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Boolean>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Boolean, or false if null. Calls JetRetrieveColumn.</summary>
+	Boolean RetrieveBoolean(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Boolean>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Byte. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	Byte RetrieveByte(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Byte>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Byte, or 0 if null. Calls JetRetrieveColumn.</summary>
+	Byte RetrieveByte(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Byte>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an Int16. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	Int16 RetrieveInt16(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Int16>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an Int16, or 0 if null. Calls JetRetrieveColumn.</summary>
+	Int16 RetrieveInt16(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Int16>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an UInt16. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	UInt16 RetrieveUInt16(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<UInt16>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an UInt16, or 0 if null. Calls JetRetrieveColumn.</summary>
+	UInt16 RetrieveUInt16(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<UInt16>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an Int32. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	Int32 RetrieveInt32(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Int32>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an Int32, or 0 if null. Calls JetRetrieveColumn.</summary>
+	Int32 RetrieveInt32(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Int32>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an UInt32. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	UInt32 RetrieveUInt32(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<UInt32>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an UInt32, or 0 if null. Calls JetRetrieveColumn.</summary>
+	UInt32 RetrieveUInt32(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<UInt32>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an Int64. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	Int64 RetrieveInt64(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Int64>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as an Int64, or 0 if null. Calls JetRetrieveColumn.</summary>
+	Int64 RetrieveInt64(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Int64>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Single. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	Single RetrieveSingle(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Single>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Single, or 0 if null. Calls JetRetrieveColumn.</summary>
+	Single RetrieveSingle(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Single>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Double. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case 0 is returned.</param>
+	Double RetrieveDouble(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Double>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Double, or 0 if null. Calls JetRetrieveColumn.</summary>
+	Double RetrieveDouble(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Double>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a DateTime. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case DateTime.MinValue is returned.</param>
+	DateTime RetrieveDateTime(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<DateTime>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a DateTime, or DateTime.MinValue if null. Calls JetRetrieveColumn.</summary>
+	DateTime RetrieveDateTime(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<DateTime>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Guid. Calls JetRetrieveColumn.
+	///When the default Bridge is in effect, converts directly from the retrieved bytes without boxing.
+	///</summary>
+	///<param name="IsNull">Set to true if the field was null, in which case Guid.Empty is returned.</param>
+	Guid RetrieveGuid(Column ^Col, [Out] bool %IsNull)
+	{
+		return RetrieveScalar<Guid>(Col, IsNull);
+	}
+
+	///<summary>Retrieves the data from the specified column at the current cursor position as a Guid, or Guid.Empty if null. Calls JetRetrieveColumn.</summary>
+	Guid RetrieveGuid(Column ^Col)
+	{
+		bool IsNull;
+		return RetrieveScalar<Guid>(Col, IsNull);
+	}
+
 	///<summary>
 	///Retrieves the sequence number of a multi-valued tagged column from an index. This is an expensive operation.
 	///Calls JetRetrieveColum with JET_bitRetrieveTag, returning the result in pretinfo->itagSequence.
@@ -397,12 +696,94 @@ internal:
 		}
 	}
 
+	//typed counterpart of RetrieveAllValues for fixed size types, converting each value with the builtin conversions directly into the result array
+	template <class T> array<T> ^RetrieveAllScalarValues(Column ^Col, ulong SizeLimit)
+	{
+		JET_SESID JetSesid = Session->_JetSesid;
+		JET_TABLEID JetTableID = TableID->_JetTableID;
+
+		JET_ENUMCOLUMNID jeci = {0};
+		jeci.columnid = Col->_JetColID;
+
+		ulong jec_ct = 0;
+		JET_ENUMCOLUMN *jec = null;
+
+		EseException::RaiseOnError(JetEnumerateColumns(JetSesid, JetTableID, 1, &jeci, &jec_ct, &jec, jet_realloc_cpp, null, SizeLimit, 0));
+
+		try
+		{
+			if(jec_ct < 1)
+				throw gcnew ApplicationException("No fields returned");
+
+			array<T> ^Values = gcnew array<T>(jec->cEnumColumnValue);
+
+			for(ulong i = 0; i < jec->cEnumColumnValue; i++)
+			{
+				JET_ENUMCOLUMNVALUE &jecv = jec->rgEnumColumnValue[i];
+
+				if(jecv.err == JET_wrnColumnNull)
+					continue; //leave default value
+
+				bool success = false;
+				Values[i] = from_memblock<T>(success, jecv.pvData, jecv.cbData, Col->_JetColTyp, Col->_CP);
+
+				if(!success)
+					EseObjects::Bridge::ThrowConversionError(Col->ColumnType, T::typeid);
+			}
+
+			return Values;
+		}
+		finally
+		{
+			FreeEnumColumn(jec, jec_ct);
+		}
+	}
+
+	//selects the typed RetrieveAllValues for the specified element type, or returns null if there isn't one
+	Object ^RetrieveAllScalarValues(Type ^type, Column ^Col, ulong SizeLimit)
+	{
+		if(type == Boolean::typeid)
+			return RetrieveAllScalarValues<Boolean>(Col, SizeLimit);
+		if(type == Byte::typeid)
+			return RetrieveAllScalarValues<Byte>(Col, SizeLimit);
+		if(type == Int16::typeid)
+			return RetrieveAllScalarValues<Int16>(Col, SizeLimit);
+		if(type == UInt16::typeid)
+			return RetrieveAllScalarValues<UInt16>(Col, SizeLimit);
+		if(type == Int32::typeid)
+			return RetrieveAllScalarValues<Int32>(Col, SizeLimit);
+		if(type == UInt32::typeid)
+			return RetrieveAllScalarValues<UInt32>(Col, SizeLimit);
+		if(type == Int64::typeid)
+			return RetrieveAllScalarValues<Int64>(Col, SizeLimit);
+		if(type == Single::typeid)
+			return RetrieveAllScalarValues<Single>(Col, SizeLimit);
+		if(type == Double::typeid)
+			return RetrieveAllScalarValues<Double>(Col, SizeLimit);
+		if(type == DateTime::typeid)
+			return RetrieveAllScalarValues<DateTime>(Col, SizeLimit);
+		if(type == Guid::typeid)
+			return RetrieveAllScalarValues<Guid>(Col, SizeLimit);
+
+		return nullptr;
+	}
+
 public:
 	///<summary>Retrieves all values of a multivalued field. Calls JetEnumerateColumns. Requires 5.1+.</summary>
-	///<remarks>Also works on single valued columns and fields.</remarks>
+	///<remarks>Also works on single valued columns and fields.
+	///<pr/>For Boolean, Byte, Int16, UInt16, Int32, UInt32, Int64, Single, Double, DateTime and Guid with the default Bridge, values are converted directly into the result array without boxing. Null values are returned as the default value of T in that case.
+	///</remarks>
 	///<param name="SizeLimit">Maximum size in bytes to return for any one value</param>
 	generic <class T> virtual array<T> ^RetrieveAllValues(Column ^Col, ulong SizeLimit)
 	{
+		if(Bridge->IsDefault)
+		{
+			Object ^Typed = RetrieveAllScalarValues(T::typeid, Col, SizeLimit);
+
+			if(Typed != nullptr)
+				return safe_cast<array<T> ^>(Typed);
+		}
+
 		JET_SESID JetSesid = Session->_JetSesid;
 		JET_TABLEID JetTableID = TableID->_JetTableID;
 
@@ -422,13 +803,12 @@ public:
 			array<T> ^Values = gcnew array<T>(jec->cEnumColumnValue);
 
 			for(ulong i = 0; i < jec->cEnumColumnValue; i++)
-				Values[i] = safe_cast<T>(Bridge->ValueBytesToObject(
+				Values[i] = safe_cast<T>(Bridge->ColumnValueToObject(
+					Col,
 					T::typeid,
 					jec->rgEnumColumnValue[i].err == JET_wrnColumnNull,
 					IntPtr(jec->rgEnumColumnValue[i].pvData),
-					jec->rgEnumColumnValue[i].cbData,
-					Col->ColumnType,
-					Col->_CP));
+					jec->rgEnumColumnValue[i].cbData));
 
 			return Values;
 		}
@@ -462,13 +842,12 @@ public:
 			array<Object ^> ^Values = gcnew array<Object ^>(jec->cEnumColumnValue);
 
 			for(ulong i = 0; i < jec->cEnumColumnValue; i++)
-				Values[i] = Bridge->ValueBytesToObject(
+				Values[i] = Bridge->ColumnValueToObject(
+					Col,
 					Type,
 					jec->rgEnumColumnValue[i].err == JET_wrnColumnNull,
 					IntPtr(jec->rgEnumColumnValue[i].pvData),
-					jec->rgEnumColumnValue[i].cbData,
-					Col->ColumnType,
-					Col->_CP);
+					jec->rgEnumColumnValue[i].cbData);
 
 			return Values;
 		}
@@ -492,16 +871,13 @@ public:
 		return RetrieveAllValues(Col, Type, 0);
 	}
 
-	///<summary>Builds an array containing all values in all fields in the row, including all values of mutli valued fields. Calls JetEnumerateColumns. Requires 5.1+.</summary>
-	///<param name="SizeLimit">Maximum size in bytes to return for any one value</param>
-	///<remarks>Multivalued fields are returned as arrays of values</remarks>
-	virtual array<Field> ^RetrieveAllFields(ulong SizeLimit)
+internal:
+	//Schema is used to refresh Cols if a column isn't found in it, or null if Cols was supplied by the caller
+	array<Field> ^RetrieveAllFields(ulong SizeLimit, IDictionary<JET_COLUMNID, Column ^> ^Cols, TableSchema ^Schema)
 	{
 		JET_SESID JetSesid = Session->_JetSesid;
 		JET_TABLEID JetTableID = TableID->_JetTableID;
 
-		IDictionary<JET_COLUMNID, Column ^> ^Cols = QueryTableColumns(JetSesid, JetTableID);
-
 		ulong jec_ct = 0;
 		JET_ENUMCOLUMN *jec = null;
 
@@ -513,31 +889,41 @@ public:
 
 			for(ulong i = 0; i < jec_ct; i++)
 			{
-				Column ^Col = Cols[jec[i].columnid];
+				Column ^Col;
+
+				if(!Cols->TryGetValue(jec[i].columnid, Col))
+				{
+					if(Schema == nullptr)
+						throw gcnew ArgumentException("Column map does not contain column " + jec[i].columnid.ToString() + " present in the record.");
+
+					//added since the map was cached (other session or outside EseObjects), refresh once
+					Schema->Invalidate();
+					Cols = Schema->GetColumnsByID(JetSesid, JetTableID);
+					Schema = nullptr;
+					Col = Cols[jec[i].columnid];
+				}
 
 				Fields[i].Col = Col;
 
 				//different structure layout depending if the column had more than one value
 				if(jec[i].err == JET_wrnColumnSingleValue)
-					Fields[i].Val = Bridge->ValueBytesToObject(
+					Fields[i].Val = Bridge->ColumnValueToObject(
+						Col,
 						Object::typeid,
 						false,
 						IntPtr(jec[i].pvData),
-						jec[i].cbData,
-						Col->ColumnType,
-						Col->_CP);
+						jec[i].cbData);
 				else
 				{
 					array<Object ^> ^Values = gcnew array<Object ^>(jec[i].cEnumColumnValue);
 
 					for(ulong j = 0; j < jec[i].cEnumColumnValue; j++)
-						Values[j] = Bridge->ValueBytesToObject(
+						Values[j] = Bridge->ColumnValueToObject(
+							Col,
 							Object::typeid,
-							jec[i].err == JET_wrnColumnNull,
+							jec[i].rgEnumColumnValue[j].err == JET_wrnColumnNull,
 							IntPtr(jec[i].rgEnumColumnValue[j].pvData),
-							jec[i].rgEnumColumnValue[j].cbData,
-							Col->ColumnType,
-							Col->_CP);
+							jec[i].rgEnumColumnValue[j].cbData);
 
 					Fields[i].Val = Bridge->MultivalueToObject<array<Object ^> ^>(Values);
 				}
@@ -551,11 +937,288 @@ public:
 		}
 	}
 
+public:
+	///<summary>Builds an array containing all values in all fields in the row, including all values of mutli valued fields. Calls JetEnumerateColumns. Requires 5.1+.</summary>
+	///<param name="SizeLimit">Maximum size in bytes to return for any one value</param>
+	///<remarks>Multivalued fields are returned as arrays of values.
+	///<pr/>Column objects come from a column map cached for the table (see ColumnMap), so the catalog is only queried the first time or after a schema change.
+	///</remarks>
+	virtual array<Field> ^RetrieveAllFields(ulong SizeLimit)
+	{
+		TableSchema ^Schema = TableSchema::ForTableID(_TableID);
+
+		return RetrieveAllFields(SizeLimit, Schema->GetColumnsByID(Session->_JetSesid, _TableID->_JetTableID), Schema);
+	}
+
+	///<summary>Builds an array containing all values in all fields in the row using a column map resolved in advance. Calls JetEnumerateColumns. Requires 5.1+.</summary>
+	///<param name="SizeLimit">Maximum size in bytes to return for any one value</param>
+	///<param name="Columns">Columns of the table by JetColumnID, such as from ColumnMap. Must include every column present in the record.</param>
+	///<remarks>Multivalued fields are returned as arrays of values</remarks>
+	array<Field> ^RetrieveAllFields(ulong SizeLimit, IDictionary<ulong, Column ^> ^Columns)
+	{
+		if(Columns == nullptr)
+			throw gcnew ArgumentNullException("Columns");
+
+		return RetrieveAllFields(SizeLimit, Columns, nullptr);
+	}
+
+	///<summary>A copy of the cached map of all columns in this cursor's table by JetColumnID, for use with RetrieveAllFields.</summary>
+	property IDictionary<ulong, Column ^> ^ColumnMap
+	{
+		IDictionary<ulong, Column ^> ^get()
+		{
+			return gcnew SortedList<ulong, Column ^>(TableSchema::ForTableID(_TableID)->GetColumnsByID(Session->_JetSesid, _TableID->_JetTableID));
+		}
+	}
+
 	virtual array<Field> ^RetrieveAllFields()
 	{
 		return RetrieveAllFields(0);
 	}
 
+	///<summary>
+	///Retrieves several columns from the current record at once. Calls JetRetrieveColumns.
+	///Each column is read into a buffer presized from the column definition; any values that did not fit are retrieved again with a second JetRetrieveColumns for just those columns.
+	///</summary>
+	///<returns>Values in the same order as the columns in the set.</returns>
+	array<Object ^> ^RetrieveColumns(ColumnSet ^Cols)
+	{
+		JET_SESID JetSesid = Session->_JetSesid;
+		JET_TABLEID JetTableID = _TableID->_JetTableID;
+		ulong ct = Cols->_Columns->Length;
+		array<Object ^> ^Values = gcnew array<Object ^>(ct);
+
+		if(ct == 0)
+			return Values;
+
+		region fl;
+		JET_RETRIEVECOLUMN *jrc = fl.alloc_array_zero<JET_RETRIEVECOLUMN>(ct);
+		char *buff = fl.alloc_array<char>(Cols->_TotalBufferSize);
+
+		for(ulong i = 0; i < ct; i++)
+		{
+			jrc[i].columnid = Cols->_Columns[i]->_JetColID;
+			jrc[i].pvData = buff;
+			jrc[i].cbData = Cols->_BufferSizes[i];
+			jrc[i].itagSequence = 1;
+			buff += Cols->_BufferSizes[i];
+		}
+
+		JET_ERR status = JetRetrieveColumns(JetSesid, JetTableID, jrc, ct);
+
+		//warnings are reported per column
+		if(status < JET_errSuccess)
+			EseException::RaiseOnError(status);
+
+		//collect the truncated columns and retrieve only those again with full size buffers
+		ulong trunc_ct = 0;
+		for(ulong i = 0; i < ct; i++)
+			if(jrc[i].err == JET_wrnBufferTruncated)
+				trunc_ct++;
+
+		if(trunc_ct)
+		{
+			JET_RETRIEVECOLUMN *jrc_trunc = fl.alloc_array_zero<JET_RETRIEVECOLUMN>(trunc_ct);
+			ulong *trunc_ix = fl.alloc_array<ulong>(trunc_ct);
+
+			for(ulong i = 0, t = 0; i < ct; i++)
+				if(jrc[i].err == JET_wrnBufferTruncated)
+				{
+					jrc_trunc[t].columnid = jrc[i].columnid;
+					jrc_trunc[t].pvData = fl.alloc_array<char>(jrc[i].cbActual);
+					jrc_trunc[t].cbData = jrc[i].cbActual;
+					jrc_trunc[t].itagSequence = 1;
+					trunc_ix[t] = i;
+					t++;
+				}
+
+			status = JetRetrieveColumns(JetSesid, JetTableID, jrc_trunc, trunc_ct);
+
+			if(status < JET_errSuccess)
+				EseException::RaiseOnError(status);
+
+			for(ulong t = 0; t < trunc_ct; t++)
+				jrc[trunc_ix[t]] = jrc_trunc[t];
+		}
+
+		for(ulong i = 0; i < ct; i++)
+		{
+			Column ^Col = Cols->_Columns[i];
+
+			switch(jrc[i].err)
+			{
+			case JET_errSuccess:
+				Values[i] = Bridge->ColumnValueToObject(Col, Cols->_Types[i], false, IntPtr(jrc[i].pvData), jrc[i].cbActual);
+				break;
+
+			case JET_wrnColumnNull:
+				Values[i] = Bridge->ColumnValueToObject(Col, Cols->_Types[i], true, IntPtr(0), 0);
+				break;
+
+			default:
+				EseException::RaiseOnError(jrc[i].err);
+				break;
+			}
+		}
+
+		return Values;
+	}
+
+	///<summary>
+	///Retrieves several columns from the current record at once. Calls JetRetrieveColumns.
+	///Builds a ColumnSet for the call; when retrieving the same columns from many records, construct a ColumnSet once and reuse it instead.
+	///</summary>
+	///<param name="Types">Type to retrieve each column as. Types must be supported by current Bridge.</param>
+	///<returns>Values in the same order as Cols.</returns>
+	array<Object ^> ^RetrieveColumns(array<Column ^> ^Cols, array<Type ^> ^Types)
+	{
+		return RetrieveColumns(gcnew ColumnSet(Cols, Types));
+	}
+
+	///<summary>
+	///Reads up to MaxRows rows, starting with the current record, into Batch. Calls JetRetrieveColumns and JetMove for each row.
+	///Afterward, the cursor is positioned on the first record not read, so repeated calls continue the scan. Stops at the end of the index or of a range set with SetUpperLimit, ForwardRange etc.
+	///</summary>
+	///<remarks>
+	///The whole batch is read by native code without returning to managed code between rows. Values are converted with the current Bridge only when accessed through Batch.
+	///<pr/>MaxRows is only a limit: storage in Batch grows with the rows actually read.
+	///</remarks>
+	///<returns>Number of rows read. Zero when there is no current record.</returns>
+	int ReadBatch(ColumnSet ^Cols, int MaxRows, RowBatch ^Batch)
+	{
+		if(Cols == nullptr)
+			throw gcnew ArgumentNullException("Cols");
+		if(Batch == nullptr)
+			throw gcnew ArgumentNullException("Batch");
+		if(MaxRows < 1)
+			throw gcnew ArgumentOutOfRangeException("MaxRows");
+		if(Cols->_Columns->Length > 0 && static_cast<ulong>(MaxRows) > ULONG_MAX / Cols->_Columns->Length)
+			throw gcnew ArgumentOutOfRangeException("MaxRows", "MaxRows times the number of columns must fit in 32 bits.");
+
+		Batch->Prepare(Cols);
+		Batch->_Bridge = Bridge;
+
+		JET_ERR status;
+		ulong rows = Batch->_Buffer->read(Session->_JetSesid, _TableID->_JetTableID, MaxRows, status);
+
+		Batch->_Count = rows;
+		Batch->_EndReached = status == JET_errNoCurrentRecord;
+
+		if(status < JET_errSuccess && status != JET_errNoCurrentRecord)
+			EseException::RaiseOnError(status);
+
+		return rows;
+	}
+
+	///<summary>
+	///Reads up to MaxRows rows, starting with the current record, into Batch in column oriented form. Reads the rows as ReadBatch does, then copies each column into one array typed from its column type.
+	///The types given in Cols are not used, and the Bridge is not involved.
+	///</summary>
+	///<returns>Number of rows read. Zero when there is no current record.</returns>
+	int ReadRecordBatch(ColumnSet ^Cols, int MaxRows, RecordBatch ^Batch)
+	{
+		if(Batch == nullptr)
+			throw gcnew ArgumentNullException("Batch");
+
+		ReadBatch(Cols, MaxRows, Batch->_Rows);
+		Batch->Load();
+
+		return Batch->_Count;
+	}
+
+	///<summary>
+	///Opens a read only, seekable stream over the value of a long column in the current record, reading it in pieces with JetRetrieveColumn at increasing offsets.
+	///A null value reads as an empty stream. The stream reads from whatever record is current, so the cursor should not be moved while it is in use.
+	///</summary>
+	///<remarks>Small reads are served from a fixed size native buffer. Reads larger than that buffer go directly into the destination array.</remarks>
+	System::IO::Stream ^OpenLongValueReader(Column ^Col)
+	{
+		return gcnew LongValueReader(_TableID, Col, 0, 1);
+	}
+
+	///<summary>As OpenLongValueReader(Column), using the flags and tag sequence of RetrieveOptions. SizeHint, SizeLimit and RetrieveOffsetLV are ignored.</summary>
+	System::IO::Stream ^OpenLongValueReader(Column ^Col, IReadRecord::RetrieveOptions ro)
+	{
+		return gcnew LongValueReader(_TableID, Col, RetrieveOptionsFlagsToBits(ro), ro.RetrieveTagSequence);
+	}
+
+	///<summary>
+	///Copies records, starting with the current record, into Dest, inserting the values of the mapped columns of each without converting them.
+	///Stops at the end of the index or of a range set with SetUpperLimit, ForwardRange etc., or once MaxRecords have been copied if MaxRecords is nonzero.
+	///Every value of multivalued columns is copied, long values are copied whole.
+	///</summary>
+	///<remarks>
+	///Records are copied in native code: each is read with JetRetrieveColumns and inserted with JetSetColumns.
+	///Each BatchSize records are inserted in their own Transaction on the Dest session, committed with JET_bitCommitLazyFlush except for the last, which is committed normally.
+	///No transaction is begun if there are no records to copy.
+	///If an error occurs, only the batch in progress is rolled back and the exception is raised; records copied by earlier batches remain.
+	///If the Dest session is already in a transaction, each batch is a nested level of it, and nothing is durable until the outer transaction commits.
+	///Autoincrement and escrow update destination columns can not be mapped.
+	///</remarks>
+	///<returns>Number of records copied.</returns>
+	Int64 CopyRecordsTo(Cursor ^Dest, ColumnMapping ^Map, Int64 MaxRecords, int BatchSize)
+	{
+		if(Dest == nullptr)
+			throw gcnew ArgumentNullException("Dest");
+		if(Map == nullptr)
+			throw gcnew ArgumentNullException("Map");
+		if(MaxRecords < 0)
+			throw gcnew ArgumentOutOfRangeException("MaxRecords");
+		if(BatchSize < 1)
+			throw gcnew ArgumentOutOfRangeException("BatchSize");
+
+		record_copier rc;
+		Int64 copied = 0;
+
+		Map->Load(rc);
+
+		for(;;)
+		{
+			//the first record of each batch is read before beginning its transaction, so none is begun when there is nothing to copy
+			JET_ERR status = rc.read_row(Session->_JetSesid, _TableID->_JetTableID);
+
+			if(status == JET_errNoCurrentRecord)
+				return copied;
+
+			if(status < JET_errSuccess)
+				EseException::RaiseOnError(status);
+
+			ulong limit = BatchSize;
+
+			if(MaxRecords && MaxRecords - copied < limit)
+				limit = static_cast<ulong>(MaxRecords - copied);
+
+			Transaction ^Batch = gcnew Transaction(Dest->Session);
+
+			try
+			{
+				ulong written;
+				bool more;
+
+				status = copy_batch(rc, Session->_JetSesid, _TableID->_JetTableID, Dest->Session->_JetSesid, Dest->_TableID->_JetTableID, limit, written, more);
+
+				if(status < JET_errSuccess)
+					EseException::RaiseOnError(status);
+
+				bool last = !more || (MaxRecords && copied + written >= MaxRecords);
+
+				if(last)
+					Batch->Commit();
+				else
+					Batch->CommitLazyFlush();
+
+				copied += written;
+
+				if(last)
+					return copied;
+			}
+			finally
+			{
+				delete Batch; //rolls back if not committed
+			}
+		}
+	}
+
 	///<summary>Represents a JET_RECSIZE, reporting record size and count measurements. Requires 6.0+.</summary>
 	value struct RecordSize
 	{
@@ -630,7 +1293,6 @@ public:
 
 	//---------------------------Update support------------------------------------
 
-	//NEXT: Add support for JetRetriveColumns to get multiple cols at once
 	//5.0: retrieve all tagged fields from JetRetrieveColumns, retrieve all fields with JetGetTableInfo JET_COLUMNLIST/JetRetrieveColumns for equivalency with JetEnumerateColumns
 	//NEXT: JetEnumerateColumns: unexploited modes and options
 	//NEXT: use of columnidNextTagged
@@ -640,11 +1302,24 @@ public:
 	{
 		Cursor ^_Cursor;
 		bool Active;
+		List<LongValueWriter ^> ^_Writers; //streams opened by OpenLongValueWriter, finished before the update completes
+
+		void FinishWriters()
+		{
+			if(!_Writers)
+				return;
+
+			for each(LongValueWriter ^w in _Writers)
+				w->Finish();
+
+			_Writers = nullptr;
+		}
 
 	internal:
 		Update(Cursor ^Cursor, ulong flags) :
 			_Cursor(Cursor),
-			Active(true)
+			Active(true),
+			_Writers(nullptr)
 		{
 			EseException::RaiseOnError(JetPrepareUpdate(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, flags));
 		}
@@ -659,6 +1334,8 @@ public:
 			if(!Active)
 				throw gcnew InvalidOperationException("Update is no longer active. It has already been completed or canceled");
 
+			FinishWriters();
+
 			ulong buffszrq = 0;
 
 			JET_ERR status = JetUpdate(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, null, 0, &buffszrq);
@@ -685,6 +1362,8 @@ public:
 			if(!Active)
 				throw gcnew InvalidOperationException("Update is no longer active. It has already been completed or canceled");
 
+			FinishWriters();
+
 			uchar *buff = null;
 
 			try
@@ -735,6 +1414,8 @@ public:
 			if(!Active)
 				throw gcnew InvalidOperationException("Update is no longer active. It has already been completed or canceled");
 
+			FinishWriters();
+
 			ulong buffsz = 2048;
 			uchar *buff = static_cast<uchar *>(alloca(buffsz));
 			ulong buffszrq = 0;
@@ -756,6 +1437,14 @@ public:
 			if(!Active)
 				throw gcnew InvalidOperationException("Update is no longer active. It has already been completed or canceled");
 
+			if(_Writers)
+			{
+				for each(LongValueWriter ^w in _Writers)
+					w->Abandon();
+
+				_Writers = nullptr;
+			}
+
 			EseException::RaiseOnError(JetPrepareUpdate(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, JET_prepCancel));
 			Active = false;
 		}
@@ -768,35 +1457,40 @@ public:
 		}
 
 	private:
-		void Set(JET_COLUMNID colid, JET_COLTYP coltyp, ushort cp, Object ^Value)
+		void SetValue(Column ^Col, Object ^Value)
 		{
-			free_list fl;
+			region fl;
 			marshal_context mc;
 			void *buff = null;
 			ulong buffsz = 0;
 			bool empty;
 
-			to_memblock_bridge(_Cursor->Bridge, Value, buff, buffsz, empty, coltyp, cp, mc, fl);
+			to_memblock_bridge(_Cursor->Bridge, Col, Value, buff, buffsz, empty, mc, fl);
+			Col->CompressValue(buff, buffsz, fl);
 
-			EseException::RaiseOnError(JetSetColumn(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, colid, buff, buffsz, empty ? JET_bitSetZeroLength : 0, null));
+			EseException::RaiseOnError(JetSetColumn(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, Col->_JetColID, buff, buffsz, empty ? JET_bitSetZeroLength : 0, null));
 		}
 
-		void Set(JET_COLUMNID colid, JET_COLTYP coltyp, ushort cp, Object ^Value, IWriteRecord::SetOptions so)
+		void SetValue(Column ^Col, Object ^Value, IWriteRecord::SetOptions so)
 		{
-			free_list fl;
+			region fl;
 			marshal_context mc;
 			void *buff = null;
 			ulong buffsz = 0;
 			bool empty;
 
-			to_memblock_bridge(_Cursor->Bridge, Value, buff, buffsz, empty, coltyp, cp, mc, fl);
+			to_memblock_bridge(_Cursor->Bridge, Col, Value, buff, buffsz, empty, mc, fl);
+
+			//a piece of a long value can't be compressed on its own
+			if(!so.AppendLV && !so.OverwriteLV && so.OffsetLV == 0)
+				Col->CompressValue(buff, buffsz, fl);
 
 			JET_GRBIT flags = SetOptionsFlagsToBits(so);
 			JET_SETINFO si = {sizeof si};
 			si.ibLongValue = so.OffsetLV;
 			si.itagSequence = so.TagSequence;
 
-			EseException::RaiseOnError(JetSetColumn(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, colid, buff, buffsz, flags | (empty ? JET_bitSetZeroLength : 0), &si));
+			EseException::RaiseOnError(JetSetColumn(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, Col->_JetColID, buff, buffsz, flags | (empty ? JET_bitSetZeroLength : 0), &si));
 		}
 
 	public:
@@ -806,7 +1500,7 @@ public:
 		///</remarks>
 		virtual void Set(Column ^Col, Object ^Value)
 		{
-			Set(Col->_JetColID, Col->_JetColTyp, Col->_CP, Value);
+			SetValue(Col, Value);
 		}
 
 		///<summary>Modifies the value of a particular column.</summary>
@@ -815,7 +1509,7 @@ public:
 		///</remarks>
 		virtual void Set(Column ^Col, Object ^Value, IWriteRecord::SetOptions so)
 		{
-			Set(Col->_JetColID, Col->_JetColTyp, Col->_CP, Value, so);
+			SetValue(Col, Value, so);
 		}
 
 		///<summary>Modifies the value of a particular column.</summary>
@@ -824,9 +1518,9 @@ public:
 		///</remarks>
 		virtual void Set(String ^Col, Object ^Value)
 		{
-			JET_COLUMNDEF jcd = _Cursor->LookupColumnDef(Col);
+			Column ^C = _Cursor->LookupColumn(Col);
 
-			Set(jcd.columnid, jcd.coltyp, jcd.cp, Value);
+			SetValue(C, Value);
 		}
 
 		///<summary>Modifies the value of a particular column.</summary>
@@ -835,17 +1529,112 @@ public:
 		///</remarks>
 		virtual void Set(String ^Col, Object ^Value, IWriteRecord::SetOptions so)
 		{
-			JET_COLUMNDEF jcd = _Cursor->LookupColumnDef(Col);
+			Column ^C = _Cursor->LookupColumn(Col);
 
-			Set(jcd.columnid, jcd.coltyp, jcd.cp, Value, so);
+			SetValue(C, Value, so);
 		}
 
-		//NEXT: JetSetColumns to set multiple columns?
+		///<summary>
+		///Opens a write only stream that replaces the value of a long column, setting it in fixed size chunks with JetSetColumn and JET_bitSetAppendLV.
+		///The stream should be closed before the update is completed. Any stream still open is finished by Complete, or abandoned by Cancel.
+		///</summary>
+		///<param name="ExpectedSize">
+		///If nonzero, the value is first preallocated to this size with JET_bitSetSizeLV and then overwritten in place.
+		///Writing more than this appends as usual, writing less trims the value when the stream is closed.
+		///</param>
+		///<remarks>Small writes are gathered in a fixed size native buffer. Writes larger than that buffer are set directly from the source array.</remarks>
+		System::IO::Stream ^OpenLongValueWriter(Column ^Col, Int64 ExpectedSize)
+		{
+			if(!Active)
+				throw gcnew InvalidOperationException("Update is no longer active. It has already been completed or canceled");
+
+			LongValueWriter ^w = gcnew LongValueWriter(_Cursor->TableID, Col, ExpectedSize, 1);
+
+			if(!_Writers)
+				_Writers = gcnew List<LongValueWriter ^>;
+
+			_Writers->Add(w);
+			return w;
+		}
+
+		///<summary>As OpenLongValueWriter(Column, Int64) with no preallocation.</summary>
+		System::IO::Stream ^OpenLongValueWriter(Column ^Col)
+		{
+			return OpenLongValueWriter(Col, 0);
+		}
+
+		///<summary>Sets the size of a long value, truncating it or extending it with zeros. Calls JetSetColumn with JET_bitSetSizeLV.</summary>
+		void SetLongValueSize(Column ^Col, ulong Size)
+		{
+			JET_SETINFO si = {sizeof si};
+			si.itagSequence = 1;
+
+			EseException::RaiseOnError(JetSetColumn(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, Col->_JetColID, null, Size, JET_bitSetSizeLV, &si));
+		}
+
+		///<summary>Modifies the values of several columns at once, Values[i] being the new value of Cols[i]. Calls JetSetColumns.</summary>
+		///<remarks>Updates do not actually affect the database unless the update is completed. See Complete.
+		///<pr/>All values are converted before a single JetSetColumns call, instead of one JetSetColumn call per column as with Set.
+		///</remarks>
+		void SetColumns(array<Column ^> ^Cols, array<Object ^> ^Values)
+		{
+			if(Cols == nullptr)
+				throw gcnew ArgumentNullException("Cols");
+			if(Values == nullptr)
+				throw gcnew ArgumentNullException("Values");
+			if(Cols->Length != Values->Length)
+				throw gcnew ArgumentException("Cols and Values must have the same number of elements");
+
+			int ct = Cols->Length;
+
+			if(ct == 0)
+				return;
+
+			region fl;
+			marshal_context mc;
+			JET_SETCOLUMN *jsc = fl.alloc_array_zero<JET_SETCOLUMN>(ct);
+
+			for(int i = 0; i < ct; i++)
+			{
+				Column ^C = Cols[i];
+
+				if(C == nullptr)
+					throw gcnew ArgumentNullException("Cols");
+
+				void *buff = null;
+				ulong buffsz = 0;
+				bool empty;
+
+				to_memblock_bridge(_Cursor->Bridge, C, Values[i], buff, buffsz, empty, mc, fl);
+				C->CompressValue(buff, buffsz, fl);
+
+				jsc[i].columnid = C->_JetColID;
+				jsc[i].pvData = buff;
+				jsc[i].cbData = buffsz;
+				jsc[i].grbit = empty ? JET_bitSetZeroLength : 0;
+				jsc[i].itagSequence = 1;
+			}
+
+			EseException::RaiseOnError(JetSetColumns(_Cursor->Session->_JetSesid, _Cursor->TableID->_JetTableID, jsc, ct));
+
+			for(int i = 0; i < ct; i++)
+				EseException::RaiseOnError(jsc[i].err);
+		}
+
+		///<summary>Modifies the values of the columns of a ColumnSet at once, Values[i] being the new value of Cols[i]. Calls JetSetColumns.</summary>
+		///<remarks>The retrieval types of the ColumnSet are not used.</remarks>
+		void SetColumns(ColumnSet ^Cols, array<Object ^> ^Values)
+		{
+			if(Cols == nullptr)
+				throw gcnew ArgumentNullException("Cols");
+
+			SetColumns(Cols->_Columns, Values);
+		}
 
 		///<summary>Copies a value from another cursor without bridging the data. Calls JetRetrieveColumn and JetSetColumn.</summary>
 		virtual void Set(Column ^DestCol, Cursor ^SrcCsr, Column ^SrcCol)
 		{
-			free_list fl;
+			region fl;
 			void *buff;
 
 			buff = alloca_array(char, ESEOBJECTS_MAX_ALLOCA);
@@ -1488,7 +2277,7 @@ public:
 	///<returns>The number of records in the returned cursor</returns>
 	static ulong IntersectIndexes([Out] Cursor ^%Results, [Out] Column ^%BookmarkCol, ICollection<Cursor ^> ^Indexes)
 	{
-		free_list fl;
+		region fl;
 		EseObjects::Session ^sess;
 		JET_INDEXRANGE *jixrs;
 		JET_RECORDLIST jrl = {sizeof jrl};
@@ -1786,4 +2575,9 @@ JET_SESID GetCursorSesid(Cursor ^Csr)
 Bridge ^GetCursorBridge(Cursor ^Csr)
 {
 	return Csr->Bridge;
+}
+
+TableID ^GetCursorTableIDObj(Cursor ^Csr)
+{
+	return Csr->TableID;
 }
\ No newline at end of file
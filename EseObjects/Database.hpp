@@ -41,6 +41,8 @@ public ref class Database
 internal:
 	JET_DBID _JetDbid;
 	Bridge ^_Bridge;
+	//column definitions cached by table name, created on first use. See TableSchema.
+	Dictionary<String ^, TableSchema ^> ^_Schemas;
 
 private:
 	Database(Session ^Session, String ^DatabaseName, JET_DBID JetDbid) :
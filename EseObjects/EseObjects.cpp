@@ -32,7 +32,10 @@
 //PCH header with system and common definitions
 #include "stdafx.h"
 
-#include "free_list.hpp"
+#include "region.hpp"
+#include "ascii.hpp"
+#include "lz.hpp"
+#include "scratch_buffer.hpp"
 
 void *JET_API jet_realloc_cpp(void *context, void *buff, ulong length)
 {
@@ -51,8 +54,15 @@ namespace EseObjects
 //max size used for alloca
 size_t const ESEOBJECTS_MAX_ALLOCA = 64;
 
+//largest scratch buffer kept by a cursor between retrievals
+size_t const ESEOBJECTS_MAX_SCRATCH_RETAIN = 0x100000;
+
+//Unicode strings and byte arrays at least this many bytes are pinned for ESE instead of copied
+size_t const ESEOBJECTS_MIN_PIN = 256;
+
 #include "ForwardReferences.hpp"
 #include "EseVersion.hpp"
+#include "NativeAllocations.hpp"
 #include "EseException.hpp"
 #include "DemandLoadFunction.hpp"
 #include "InternalBridgeFunctions.hpp"
@@ -62,12 +72,19 @@ size_t const ESEOBJECTS_MAX_ALLOCA = 64;
 #include "Transaction.hpp"
 #include "TableID.hpp"
 #include "Column.hpp"
+#include "ColumnSet.hpp"
+#include "TableSchema.hpp"
+#include "Serializer.hpp"
 #include "Bridge.hpp"
 #include "Positioning.hpp"
 #include "Key.hpp"
 #include "Index.hpp"
 #include "Bookmark.hpp"
 #include "SecondaryBookmark.hpp"
+#include "LongValueStream.hpp"
+#include "RowBatch.hpp"
+#include "RecordBatch.hpp"
+#include "RecordCopy.hpp"
 #include "Cursor.hpp"
 #include "Table.hpp"
 
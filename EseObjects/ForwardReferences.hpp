@@ -39,6 +39,7 @@ ref class Key;
 ref class Bookmark;
 ref class SecondaryBookmark;
 ref struct Bridge;
+ref class TableSchema;
 interface struct ReadRecord;
 interface struct WriteRecord;
 
@@ -47,10 +48,13 @@ JET_SESID GetTableSesid(Table ^Tab);
 TableID ^GetTableIDObj(Table ^Tab);
 Bridge ^GetTableBridge(Table ^Tab);
 Table ^MakeTableFromTableID(TableID ^Tabid);
+void InvalidateTableSchema(Table ^Tab);
+Dictionary<JET_COLUMNID, ulong> ^GetTableThresholds(TableID ^Tabid);
 
 JET_TABLEID GetCursorTableID(Cursor ^Csr);
 JET_SESID GetCursorSesid(Cursor ^Csr);
 Bridge ^GetCursorBridge(Cursor ^Csr);
+TableID ^GetCursorTableIDObj(Cursor ^Csr);
 
 Bridge ^GetDefaultBridge();
 
@@ -48,6 +48,8 @@ public:
 		///<remarks>If true, sort is descending. If false, sort is ascending</remarks>
 		bool SortDescending;
 		UnicodeMapFlags MapFlags;
+		///<remarks>If true, the column is multivalued and the index holds an entry for each of its values.</remarks>
+		bool MultiValued;
 	};
 
 internal:
@@ -84,6 +86,15 @@ internal:
 		EseException::RaiseOnError(JetGetTableIndexInfo(sesid, tableid, indexname, _JetIndexID, sizeof(JET_INDEXID), JET_IdxInfoIndexId));
 	}
 
+	static bool IsMultiValued(JET_SESID sesid, JET_TABLEID tableid, char const *colname)
+	{
+		JET_COLUMNDEF jcd = {sizeof jcd};
+
+		EseException::RaiseOnError(JetGetTableColumnInfo(sesid, tableid, colname, &jcd, sizeof jcd, JET_ColInfo));
+
+		return (jcd.grbit & JET_bitColumnMultiValued) != 0;
+	}
+
 	static bool CollectInformation(JET_SESID sesid, JET_TABLEID tableid, char const *indexname_filter, array<Index ^> ^indexes)
 	{
 		JET_ERR status;
@@ -149,6 +160,8 @@ internal:
 
 				EseException::RaiseOnError(JetGetTableIndexInfo(sesid, tableid, retrieved_index_name, indexes[i]->_JetIndexID, sizeof(JET_INDEXID), JET_IdxInfoIndexId));
 
+				indexes[i]->_ConditionalColumns = QueryConditionalColumns(sesid, tableid, retrieved_index_name);
+
 				for(int j = 0; j < key_count; j++)
 				{
 					EseException::RaiseOnError(JetRetrieveColumn(sesid, jil.tableid, jil.columnidcoltyp, &local_ulong, sizeof local_ulong, null, 0, null));
@@ -179,6 +192,7 @@ internal:
 						EseException::RaiseOnError(JetRetrieveColumn(sesid, jil.tableid, jil.columnidcolumnname, colname, sizeof colname, &name_len, 0, null));
 
 						KeyColumns[j].Name = astring_from_memblock(colname, name_len);
+						KeyColumns[j].MultiValued = IsMultiValued(sesid, tableid, colname);
 					}
 
 					status = JetMove(sesid, jil.tableid, JET_MoveNext, 0);
@@ -244,6 +258,40 @@ internal:
 		return b;
 	}
 
+	array<ConditionalColumn> ^_ConditionalColumns; //null when they couldn't be read
+
+	//JET_IdxInfoCreateIndex requires 6.1+; returns null when the conditional columns can't be read
+	static array<ConditionalColumn> ^QueryConditionalColumns(JET_SESID sesid, JET_TABLEID tableid, char const *indexname)
+	{
+		if(GetEseVersionMajor() < 6 || (GetEseVersionMajor() == 6 && GetEseVersionMinor() < 1))
+			return nullptr;
+
+		region fl;
+		JET_INDEXCREATE *jic = null;
+		JET_ERR status = JET_errBufferTooSmall;
+
+		//the index definition is returned in one block with its strings; grow until it fits
+		for(ulong size = 0x400; status == JET_errBufferTooSmall && size <= 0x40000; size *= 2)
+		{
+			jic = static_cast<JET_INDEXCREATE *>(fl.alloc_bytes(size));
+			status = JetGetTableIndexInfo(sesid, tableid, indexname, jic, size, JET_IdxInfoCreateIndex);
+		}
+
+		if(status < JET_errSuccess || jic->cbStruct < sizeof *jic)
+			return nullptr;
+
+		array<ConditionalColumn> ^ccs = gcnew array<ConditionalColumn>(jic->cConditionalColumn);
+
+		for(ulong k = 0; k < jic->cConditionalColumn; k++)
+		{
+			ccs[k].Name = marshal_as<String ^>(jic->rgconditionalcolumn[k].szColumnName);
+			ccs[k].MustBeNull = (jic->rgconditionalcolumn[k].grbit & JET_bitIndexColumnMustBeNull) != 0;
+			ccs[k].MustBeNonNull = (jic->rgconditionalcolumn[k].grbit & JET_bitIndexColumnMustBeNonNull) != 0;
+		}
+
+		return ccs;
+	}
+
 public:
 	///<summary>Parameters for a tuple index. A zero value represents default or not present.</summary>
 	value struct TupleLimits
@@ -360,7 +408,7 @@ internal:
 		return b;
 	}
 
-	template <class T> static void PopulateJetIndexCreateCommon(T &jic, CreateOptions %NewIx, marshal_context %mc, free_list &fl)
+	template <class T> static void PopulateJetIndexCreateCommon(T &jic, CreateOptions %NewIx, marshal_context %mc, region &fl)
 	{
 		String ^Name = NewIx.Name;
 
@@ -430,11 +478,12 @@ internal:
 				jic.rgconditionalcolumn[k].cbStruct = sizeof jic.rgconditionalcolumn[k];
 				jic.rgconditionalcolumn[k].szColumnName = const_cast<char *>(mc.marshal_as<char const *>(Name));
 				jic.rgconditionalcolumn[k].grbit = ConditionalColumnFlagsToBits(CC);
+				k++;
 			}
 		}
 	}
 
-	static JET_INDEXCREATE MakeJetIndexCreate(CreateOptions %NewIx, marshal_context %mc, free_list &fl)
+	static JET_INDEXCREATE MakeJetIndexCreate(CreateOptions %NewIx, marshal_context %mc, region &fl)
 	{
 		JET_INDEXCREATE jic = {sizeof jic};
 		PopulateJetIndexCreateCommon(jic, NewIx, mc, fl);
@@ -448,7 +497,7 @@ internal:
 		return jic;
 	}
 
-	static JET_INDEXCREATE_SHORT MakeJetIndexCreateShort(CreateOptions %NewIx, marshal_context %mc, free_list &fl)
+	static JET_INDEXCREATE_SHORT MakeJetIndexCreateShort(CreateOptions %NewIx, marshal_context %mc, region &fl)
 	{
 		JET_INDEXCREATE_SHORT jic = {sizeof jic};
 		PopulateJetIndexCreateCommon(jic, NewIx, mc, fl);
@@ -474,9 +523,17 @@ internal:
 		for each(String ^s in ColNames)
 		{
 			_KeyColumns[i].Name = s->Substring(1);
+
+			marshal_context mc;
+			_KeyColumns[i].MultiValued = IsMultiValued(sesid, tableid, mc.marshal_as<char const *>(_KeyColumns[i].Name));
 			i++;
 		}
 
+		_ConditionalColumns = gcnew array<ConditionalColumn>(co.ConditionalColumns ? co.ConditionalColumns->Count : 0);
+
+		if(co.ConditionalColumns)
+			co.ConditionalColumns->CopyTo(_ConditionalColumns, 0);
+
 		FixIndexID(sesid, tableid);
 	}
 
@@ -520,7 +577,7 @@ public:
 		JET_SESID sesid = GetTableSesid(Table);
 
 		marshal_context mc;
-		free_list fl;
+		region fl;
 
 		if(co.KeyMost) //need full 6.0+ only struct
 		{
@@ -579,6 +636,15 @@ public:
 		IEnumerable<KeyColumn> ^get() {return _KeyColumns;}
 	}
 
+	///<summary>
+	///Columns that must be null or non null for a record to appear in the index.
+	///<pr/>Reading these from an existing index requires 6.1+; null if they couldn't be read.
+	///</summary>
+	property IEnumerable<ConditionalColumn> ^ConditionalColumns
+	{
+		IEnumerable<ConditionalColumn> ^get() {return _ConditionalColumns;}
+	}
+
 	property bool Unique
 	{
 		bool get() {return _JetFlags & JET_bitIndexUnique;}
@@ -44,7 +44,7 @@ template <class T> T from_memblock(bool &success, void *buff, ulong max, JET_COL
 	return T();
 }
 
-template <class T> bool to_memblock(T o, void *&buff, ulong &bytes, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <class T> bool to_memblock(T o, void *&buff, ulong &bytes, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	unsupported_type_conversion();
 	return false;
@@ -156,12 +156,10 @@ template <> Guid from_memblock(bool &success, void *buff, ulong max, JET_COLTYP
 			if(max < 16)
 				throw gcnew InvalidOperationException("Data must be at least 16 bytes to extract GUID.");
 
-			array<uchar> ^arr = gcnew array<uchar>(16);
+			//same layout as Guid(array<uchar> ^) without the intermediate array
+			uchar *b = reinterpret_cast<uchar *>(buff);
 
-			for(ulong i = 0; i < 16; i++)
-				arr[i] = (reinterpret_cast<uchar *>(buff))[i];
-
-			return Guid(arr);
+			return Guid(*reinterpret_cast<int *>(b), *reinterpret_cast<short *>(b + 4), *reinterpret_cast<short *>(b + 6), b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
 		}
 	}
 
@@ -169,9 +167,23 @@ template <> Guid from_memblock(bool &success, void *buff, ulong max, JET_COLTYP
 	return Guid();
 }
 
+//widens into a stack buffer, or a region for long text, when the text is pure ASCII, as it nearly always is
+//otherwise Encoding::ASCII is used to substitute the other characters as before
 String ^astring_from_memblock(void *buff, ulong max)
 {
-	return gcnew String(reinterpret_cast<char *>(buff), 0, max, System::Text::Encoding::ASCII);
+	char *src = reinterpret_cast<char *>(buff);
+
+	if(max == 0)
+		return String::Empty;
+
+	wchar_t local[256];
+	region fl;
+	wchar_t *dest = max <= _countof(local) ? local : fl.alloc_array<wchar_t>(max);
+
+	if(ascii_widen(src, dest, max))
+		return gcnew String(dest, 0, max);
+
+	return gcnew String(src, 0, max, System::Text::Encoding::ASCII);
 }
 
 template <> String ^from_memblock(bool &success, void *buff, ulong max, JET_COLTYP coltyp, ushort cp)
@@ -185,7 +197,7 @@ template <> String ^from_memblock(bool &success, void *buff, ulong max, JET_COLT
 	case JET_coltypBinary:
 	case JET_coltypLongBinary:
 		if(cp == 1252)
-			return gcnew String(reinterpret_cast<char *>(buff), 0, max, System::Text::Encoding::ASCII);
+			return astring_from_memblock(buff, max);
 		else if(cp == 1200)
 			return gcnew String(reinterpret_cast<wchar_t *>(buff), 0, max / sizeof(wchar_t));
 	}
@@ -199,8 +211,8 @@ template <> array<uchar> ^from_memblock(bool &success, void *buff, ulong max, JE
 {
 	array<uchar> ^arr = gcnew array<uchar>(max);
 
-	for(ulong i = 0; i < max; i++)
-		arr[i] = (reinterpret_cast<uchar *>(buff))[i];
+	if(max)
+		System::Runtime::InteropServices::Marshal::Copy(IntPtr(buff), arr, 0, max);
 
 	success = true;
 	return arr;
@@ -289,105 +301,128 @@ Object ^from_memblock_binserialize(bool &success, void *buff, ulong max, JET_COL
 	return formatter->Deserialize(stream);
 }
 
-//convert to default
-Object ^from_memblock(bool &success, void *buff, ulong max, JET_COLTYP coltyp, ushort cp)
+//builtin conversion from column data to one managed type, resolved once by resolve_reader and called directly for each value
+typedef Object ^(__clrcall *value_reader)(bool &success, void *buff, ulong max, JET_COLTYP coltyp, ushort cp);
+
+template <class T> Object ^read_boxed(bool &success, void *buff, ulong max, JET_COLTYP coltyp, ushort cp)
+{
+	return from_memblock<T>(success, buff, max, coltyp, cp);
+}
+
+//reader for the default type of a column type
+value_reader resolve_default_reader(JET_COLTYP coltyp, ushort cp)
 {
 	switch(coltyp)
 	{
 	case JET_coltypBit:
-		return from_memblock<Boolean>(success, buff, max, coltyp, cp);
+		return &read_boxed<Boolean>;
 
 	case JET_coltypUnsignedByte:
-		return from_memblock<Byte>(success, buff, max, coltyp, cp);
+		return &read_boxed<Byte>;
 
 	case JET_coltypShort:
-		return from_memblock<Int16>(success, buff, max, coltyp, cp);
+		return &read_boxed<Int16>;
 
 	case JET_coltypUnsignedShort:
-		return from_memblock<UInt16>(success, buff, max, coltyp, cp);
+		return &read_boxed<UInt16>;
 
 	case JET_coltypLong:
-		return from_memblock<Int32>(success, buff, max, coltyp, cp);
+		return &read_boxed<Int32>;
 
 	case JET_coltypUnsignedLong:
-		return from_memblock<UInt32>(success, buff, max, coltyp, cp);
+		return &read_boxed<UInt32>;
 
 	case JET_coltypLongLong:
 	case JET_coltypCurrency:
-		return from_memblock<Int64>(success, buff, max, coltyp, cp);
+		return &read_boxed<Int64>;
 
 	case JET_coltypIEEESingle:
-		return from_memblock<Single>(success, buff, max, coltyp, cp);
+		return &read_boxed<Single>;
 
 	case JET_coltypIEEEDouble:
-		return from_memblock<Double>(success, buff, max, coltyp, cp);
+		return &read_boxed<Double>;
 
 	case JET_coltypDateTime:
-		return from_memblock<DateTime>(success, buff, max, coltyp, cp);
+		return &read_boxed<DateTime>;
 
 	case JET_coltypText:
 	case JET_coltypLongText:
 		if(cp == 1252 || cp == 1200) //a known code page in other words
-			return from_memblock<String ^>(success, buff, max, coltyp, cp);
+			return &read_boxed<String ^>;
 		else
-			return from_memblock<array<uchar> ^>(success, buff, max, coltyp, cp);
+			return &read_boxed<array<uchar> ^>;
 
 	case JET_coltypGUID:
-		return from_memblock<Guid>(success, buff, max, coltyp, cp);
+		return &read_boxed<Guid>;
 
 	case JET_coltypNil:
 	case JET_coltypBinary:
 	case JET_coltypLongBinary:
 	default:
-		return from_memblock<array<uchar> ^>(success, buff, max, coltyp, cp);
+		return &read_boxed<array<uchar> ^>;
 	}
-
-	success = false;
-	return nullptr;
 }
 
-Object ^from_memblock(bool &success, Type ^type, void *bytes, ulong size, JET_COLTYP coltyp, ushort cp)
+//reader for the requested type, or null if there's no builtin conversion to it
+value_reader resolve_reader(Type ^type, JET_COLTYP coltyp, ushort cp)
 {
- 	if(type == Boolean::typeid)
-		return from_memblock<Boolean>(success, bytes, size, coltyp, cp);
+	if(type == Boolean::typeid)
+		return &read_boxed<Boolean>;
 	if(type == Byte::typeid)
-		return from_memblock<Byte>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Byte>;
 	if(type == SByte::typeid)
-		return from_memblock<SByte>(success, bytes, size, coltyp, cp);
+		return &read_boxed<SByte>;
 	if(type == Char::typeid)
-		return from_memblock<Char>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Char>;
 	if(type == Single::typeid)
-		return from_memblock<Single>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Single>;
 	if(type == Double::typeid)
-		return from_memblock<Double>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Double>;
 	if(type == Int16::typeid)
-		return from_memblock<Int16>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Int16>;
 	if(type == Int32::typeid)
-		return from_memblock<Int32>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Int32>;
 	if(type == Int64::typeid)
-		return from_memblock<Int64>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Int64>;
 	if(type == UInt16::typeid)
-		return from_memblock<UInt16>(success, bytes, size, coltyp, cp);
+		return &read_boxed<UInt16>;
 	if(type == UInt32::typeid)
-		return from_memblock<UInt32>(success, bytes, size, coltyp, cp);
+		return &read_boxed<UInt32>;
 	if(type == UInt64::typeid)
-		return from_memblock<UInt64>(success, bytes, size, coltyp, cp);
+		return &read_boxed<UInt64>;
 	if(type == Guid::typeid)
-		return from_memblock<Guid>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Guid>;
 	if(type == String::typeid)
-		return from_memblock<String ^>(success, bytes, size, coltyp, cp);
+		return &read_boxed<String ^>;
 	if(type == array<uchar>::typeid)
-		return from_memblock<array<uchar> ^>(success, bytes, size, coltyp, cp);
+		return &read_boxed<array<uchar> ^>;
 	if(type == DateTime::typeid)
-		return from_memblock<DateTime>(success, bytes, size, coltyp, cp);
+		return &read_boxed<DateTime>;
 	if(type == Key::typeid)
-		return from_memblock<Key ^>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Key ^>;
 	if(type == Bookmark::typeid)
-		return from_memblock<Bookmark ^>(success, bytes, size, coltyp, cp);
+		return &read_boxed<Bookmark ^>;
 	if(type == SecondaryBookmark::typeid)
-		return from_memblock<SecondaryBookmark ^>(success, bytes, size, coltyp, cp);
+		return &read_boxed<SecondaryBookmark ^>;
 	if(type == Object::typeid)
-		return from_memblock(success, bytes, size, coltyp, cp);
+		return resolve_default_reader(coltyp, cp);
+
+	//serializable types are left to the caller, which may have a serializer other than BinaryFormatter
+	return null;
+}
+
+//convert to default
+Object ^from_memblock(bool &success, void *buff, ulong max, JET_COLTYP coltyp, ushort cp)
+{
+	return resolve_default_reader(coltyp, cp)(success, buff, max, coltyp, cp);
+}
+
+Object ^from_memblock(bool &success, Type ^type, void *bytes, ulong size, JET_COLTYP coltyp, ushort cp)
+{
+	value_reader read = resolve_reader(type, coltyp, cp);
+
+	if(read)
+		return read(success, bytes, size, coltyp, cp);
 	if(type->IsSerializable)
 		return from_memblock_binserialize(success, bytes, size, coltyp, cp);
 
@@ -405,14 +440,15 @@ Object ^from_memblock(bool &success, Type ^type, void *bytes, ulong size, JET_CO
 //	return T();
 //}
 
-template <class T, class U> void alloc_and_assign(T t, void *&buff, ulong &max, free_list &fl)
+//the value is stored in the region's inline storage, so no heap allocation is made for it
+template <class T, class U> void alloc_and_assign(T t, void *&buff, ulong &max, region &fl)
 {
-	buff = fl.alloc_zero<U>();
+	buff = fl.alloc_bytes_zero(sizeof(U));
 	max = sizeof(U);
 	*reinterpret_cast<U *>(buff) = t;
 }
 
-template <class T> bool to_memblock_scalar(T t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <class T> bool to_memblock_scalar(T t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	empty = false; //these fixed size types are never empty
 
@@ -458,21 +494,21 @@ template <class T> bool to_memblock_scalar(T t, void *&buff, ulong &max, bool &e
 }
 
 //scalar conversions:
-template <> bool to_memblock(Boolean t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Boolean>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(Byte t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Byte>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(SByte t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<SByte>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(Char t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Char>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(Single t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Single>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(Double t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Double>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(Int16 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Int16>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(Int32 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Int32>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(Int64 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<Int64>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(UInt16 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<UInt16>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(UInt32 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<UInt32>(t, buff, max, empty, coltyp, cp, mc, fl);}
-template <> bool to_memblock(UInt64 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl) {return to_memblock_scalar<UInt64>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Boolean t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Boolean>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Byte t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Byte>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(SByte t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<SByte>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Char t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Char>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Single t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Single>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Double t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Double>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Int16 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Int16>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Int32 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Int32>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(Int64 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<Int64>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(UInt16 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<UInt16>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(UInt32 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<UInt32>(t, buff, max, empty, coltyp, cp, mc, fl);}
+template <> bool to_memblock(UInt64 t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl) {return to_memblock_scalar<UInt64>(t, buff, max, empty, coltyp, cp, mc, fl);}
 
 //always uses binary representation of data
-template <> bool to_memblock(array<uchar> ^arr, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(array<uchar> ^arr, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	if(arr == nullptr)
 	{
@@ -483,25 +519,37 @@ template <> bool to_memblock(array<uchar> ^arr, void *&buff, ulong &max, bool &e
 	}
 
 	max = arr->Length;
-	uchar *buffc = fl.alloc_array<uchar>(max);
 
 	if(max == 0)
+	{
 		empty = true;
+		buff = fl.alloc_bytes(0);
+	}
+	else if(max >= ESEOBJECTS_MIN_PIN) //large arrays are handed to ESE in place
+		buff = fl.pin(arr);
+	else
+	{
+		pin_ptr<uchar> src = &arr[0];
 
-	for(ulong i = 0; i < max; i++)
-		buffc[i] = arr[i];
-
-	buff = buffc;
+		buff = fl.alloc_bytes(max);
+		memcpy(buff, src, max);
+	}
 	
 	return true;
 }
 
-template <> bool to_memblock(Guid g, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(Guid g, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
-	return to_memblock<array<uchar> ^>(g.ToByteArray(), buff, max, empty, coltyp, cp, mc, fl);
+	//the in memory layout of Guid is the same as ToByteArray, so it's copied directly without the intermediate array
+	empty = false;
+	buff = fl.alloc_bytes_zero(sizeof(Guid));
+	max = sizeof(Guid);
+	*reinterpret_cast<Guid *>(buff) = g;
+
+	return true;
 }
 
-template <> bool to_memblock(Decimal t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(Decimal t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	empty = false; //these fixed size types can't be empty
 
@@ -546,7 +594,7 @@ template <> bool to_memblock(Decimal t, void *&buff, ulong &max, bool &empty, JE
 	return false;
 }
 
-template <> bool to_memblock(String ^s, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(String ^s, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	if(s == nullptr)
 	{
@@ -567,14 +615,39 @@ template <> bool to_memblock(String ^s, void *&buff, ulong &max, bool &empty, JE
 	case JET_coltypLongBinary:
 		if(cp == 1252)
 		{
-			buff = const_cast<char *>(mc.marshal_as<char const *>(s));
+			pin_ptr<wchar_t const> src = PtrToStringChars(s);
+
 			max = s->Length;
+
+			//checked first so the fallback doesn't leave an unused copy in the region
+			if(ascii_only(src, max))
+			{
+				char *buffc = fl.alloc_array<char>(max);
+
+				ascii_narrow(src, buffc, max);
+				buff = buffc;
+			}
+			else //characters outside ASCII go through the system code page
+				buff = const_cast<char *>(mc.marshal_as<char const *>(s));
+
 			return true;
 		}
 		else if(cp == 1200)
 		{
-			buff = const_cast<wchar_t *>(mc.marshal_as<wchar_t const *>(s));
-			max = s->Length * 2;
+			max = s->Length * sizeof(wchar_t);
+
+			//the characters are already UTF-16, so large strings are handed to ESE in place
+			//small ones are cheaper to copy than to pin
+			if(max >= ESEOBJECTS_MIN_PIN)
+				buff = fl.pin(s);
+			else
+			{
+				pin_ptr<wchar_t const> src = PtrToStringChars(s);
+
+				buff = fl.alloc_bytes(max);
+				memcpy(buff, src, max);
+			}
+
 			return true;
 		}
 	}
@@ -582,7 +655,7 @@ template <> bool to_memblock(String ^s, void *&buff, ulong &max, bool &empty, JE
 	return false;
 }
 
-template <> bool to_memblock(DateTime t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(DateTime t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	empty = false;
 
@@ -602,7 +675,7 @@ template <> bool to_memblock(DateTime t, void *&buff, ulong &max, bool &empty, J
 	return false;
 }
 
-template <> bool to_memblock(Key ^t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(Key ^t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	switch(coltyp)
 	{
@@ -624,7 +697,7 @@ template <> bool to_memblock(Key ^t, void *&buff, ulong &max, bool &empty, JET_C
 	return false;
 }
 
-template <> bool to_memblock(Bookmark ^t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(Bookmark ^t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	switch(coltyp)
 	{
@@ -646,7 +719,7 @@ template <> bool to_memblock(Bookmark ^t, void *&buff, ulong &max, bool &empty,
 	return false;
 }
 
-template <> bool to_memblock(SecondaryBookmark ^t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+template <> bool to_memblock(SecondaryBookmark ^t, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	switch(coltyp)
 	{
@@ -668,7 +741,7 @@ template <> bool to_memblock(SecondaryBookmark ^t, void *&buff, ulong &max, bool
 	return false;
 }
 
-bool to_memblock_binserialize(Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+bool to_memblock_binserialize(Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
 	System::Runtime::Serialization::Formatters::Binary::BinaryFormatter ^formatter = gcnew System::Runtime::Serialization::Formatters::Binary::BinaryFormatter();
 	System::IO::MemoryStream ^stream = gcnew System::IO::MemoryStream();
@@ -679,50 +752,67 @@ bool to_memblock_binserialize(Object ^o, void *&buff, ulong &max, bool &empty, J
 	return true;
 }
 
-//convert from object
-template <> bool to_memblock(Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, free_list &fl)
+//builtin conversion from one managed type to column data, resolved once by resolve_writer and called directly for each value
+typedef bool (__clrcall *value_writer)(Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl);
+
+template <class T> bool write_unboxed(Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
 {
-	System::Type ^ty = o->GetType();
+	return to_memblock<T>(safe_cast<T>(o), buff, max, empty, coltyp, cp, mc, fl);
+}
 
+//writer for values of the specified type, or null if there's no builtin conversion from it
+value_writer resolve_writer(Type ^ty)
+{
 	if(ty == Boolean::typeid)
-		return to_memblock<Boolean>(safe_cast<Boolean>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Boolean>;
 	if(ty == Byte::typeid)
-		return to_memblock<Byte>(safe_cast<Byte>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Byte>;
 	if(ty == SByte::typeid)
-		return to_memblock<SByte>(safe_cast<SByte>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<SByte>;
 	if(ty == Char::typeid)
-		return to_memblock<Char>(safe_cast<Char>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Char>;
 	if(ty == Single::typeid)
-		return to_memblock<Single>(safe_cast<Single>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Single>;
 	if(ty == Double::typeid)
-		return to_memblock<Double>(safe_cast<Double>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Double>;
 	if(ty == Int16::typeid)
-		return to_memblock<Int16>(safe_cast<Int16>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Int16>;
 	if(ty == Int32::typeid)
-		return to_memblock<Int32>(safe_cast<Int32>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Int32>;
 	if(ty == Int64::typeid)
-		return to_memblock<Int64>(safe_cast<Int64>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Int64>;
 	if(ty == UInt16::typeid)
-		return to_memblock<UInt16>(safe_cast<UInt16>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<UInt16>;
 	if(ty == UInt32::typeid)
-		return to_memblock<UInt32>(safe_cast<UInt32>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<UInt32>;
 	if(ty == UInt64::typeid)
-		return to_memblock<UInt64>(safe_cast<UInt64>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<UInt64>;
 	if(ty == Guid::typeid)
-		return to_memblock<Guid>(safe_cast<Guid>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Guid>;
 	if(ty == String::typeid)
-		return to_memblock<String ^>(safe_cast<String ^>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<String ^>;
 	if(ty == array<uchar>::typeid)
-		return to_memblock<array<uchar> ^>(safe_cast<array<uchar> ^>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<array<uchar> ^>;
 	if(ty == DateTime::typeid)
-		return to_memblock<DateTime>(safe_cast<DateTime>(o), buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<DateTime>;
 	if(ty == Key::typeid)
-		return to_memblock<Key ^>((Key ^)o, buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Key ^>;
 	if(ty == Bookmark::typeid)
-		return to_memblock<Bookmark ^>((Bookmark ^)o, buff, max, empty, coltyp, cp, mc, fl);
+		return &write_unboxed<Bookmark ^>;
 	if(ty == SecondaryBookmark::typeid)
-		return to_memblock<SecondaryBookmark ^>((SecondaryBookmark ^)o, buff, max, empty, coltyp, cp, mc, fl);
-	
+		return &write_unboxed<SecondaryBookmark ^>;
+
+	//serializable types are left to the caller, as with resolve_reader
+	return null;
+}
+
+//convert from object
+template <> bool to_memblock(Object ^o, void *&buff, ulong &max, bool &empty, JET_COLTYP coltyp, ushort cp, marshal_context %mc, region &fl)
+{
+	value_writer write = resolve_writer(o->GetType());
+
+	if(write)
+		return write(o, buff, max, empty, coltyp, cp, mc, fl);
 	if(o->GetType()->IsSerializable)
 		return to_memblock_binserialize(o, buff, max, empty, coltyp, cp, mc, fl);
 
@@ -55,13 +55,13 @@ internal:
 
 	static void LoadFieldIntoTableID(JET_SESID sesid, JET_TABLEID tabid, Bridge ^Bridge, Column ^Col, Object ^Val, JET_GRBIT flags)
 	{
-		free_list fl;
+		region fl;
 		marshal_context mc;
 		void *data;
 		ulong data_len;
 		bool empty;
 
-		to_memblock_bridge(Bridge, Val, data, data_len, empty, Col->_JetColTyp, Col->_CP, mc, fl);
+		to_memblock_bridge(Bridge, Col, Val, data, data_len, empty, mc, fl);
 
 		EseException::RaiseOnError(JetMakeKey(sesid, tabid, data, data_len, flags | (empty ? JET_bitKeyDataZeroLength : 0)));
 	}
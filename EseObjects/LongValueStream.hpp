@@ -0,0 +1,416 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  EseObjects.LongValueStream - Stream access to long values
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//size of the buffer used by long value streams for small reads and writes
+ulong const ESEOBJECTS_LV_STREAM_BUFFER = 0x10000;
+
+///<summary>Read only, seekable stream over one long value of the current record. Created by Cursor.OpenLongValueReader.</summary>
+private ref class LongValueReader : public System::IO::Stream
+{
+	TableID ^_TableID;
+	JET_COLUMNID _ColID;
+	JET_GRBIT _Flags;
+	ulong _TagSequence;
+	Int64 _Length;
+	Int64 _Position;
+
+	char *_Buffer; //ESEOBJECTS_LV_STREAM_BUFFER bytes, allocated on the first small read
+	Int64 _BufferStart; //offset of the value the buffer holds
+	ulong _BufferCt; //bytes valid in the buffer
+
+	//retrieves up to cb bytes at offset Pos into dest, returning the number of bytes retrieved
+	ulong Fetch(Int64 Pos, void *dest, ulong cb)
+	{
+		JET_RETINFO ret_info = {sizeof ret_info};
+		ulong actual = 0;
+
+		ret_info.ibLongValue = static_cast<ulong>(Pos);
+		ret_info.itagSequence = _TagSequence;
+
+		JET_ERR status = JetRetrieveColumn(_TableID->Session->_JetSesid, _TableID->_JetTableID, _ColID, dest, cb, &actual, _Flags, &ret_info);
+
+		if(status == JET_wrnColumnNull)
+			return 0;
+		if(status < JET_errSuccess)
+			EseException::RaiseOnError(status);
+
+		return static_cast<ulong>(Math::Min(static_cast<Int64>(cb), _Length - Pos));
+	}
+
+	void CheckOpen()
+	{
+		if(!_TableID)
+			throw gcnew ObjectDisposedException("LongValueReader");
+	}
+
+internal:
+	LongValueReader(TableID ^TabID, Column ^Col, JET_GRBIT Flags, ulong TagSequence) :
+		_TableID(TabID),
+		_ColID(0),
+		_Flags(Flags),
+		_TagSequence(TagSequence ? TagSequence : 1),
+		_Length(0),
+		_Position(0),
+		_Buffer(null),
+		_BufferStart(0),
+		_BufferCt(0)
+	{
+		if(Col == nullptr)
+			throw gcnew ArgumentNullException("Col");
+
+		_ColID = Col->_JetColID;
+
+		JET_RETINFO ret_info = {sizeof ret_info};
+		ulong actual = 0;
+
+		ret_info.itagSequence = _TagSequence;
+
+		//a zero size retrieve gets the size of the value
+		JET_ERR status = JetRetrieveColumn(_TableID->Session->_JetSesid, _TableID->_JetTableID, _ColID, null, 0, &actual, _Flags, &ret_info);
+
+		if(status < JET_errSuccess)
+			EseException::RaiseOnError(status);
+
+		if(status != JET_wrnColumnNull)
+			_Length = actual;
+	}
+
+public:
+	~LongValueReader()
+	{
+		this->!LongValueReader();
+		_TableID = nullptr;
+	}
+
+	!LongValueReader()
+	{
+		delete[] _Buffer;
+		_Buffer = null;
+	}
+
+	virtual property bool CanRead {bool get() override {return _TableID != nullptr;}}
+	virtual property bool CanSeek {bool get() override {return _TableID != nullptr;}}
+	virtual property bool CanWrite {bool get() override {return false;}}
+
+	virtual property Int64 Length {Int64 get() override {CheckOpen(); return _Length;}}
+
+	virtual property Int64 Position
+	{
+		Int64 get() override {CheckOpen(); return _Position;}
+
+		void set(Int64 value) override
+		{
+			CheckOpen();
+
+			if(value < 0)
+				throw gcnew ArgumentOutOfRangeException("value");
+
+			_Position = value;
+		}
+	}
+
+	virtual int Read(array<uchar> ^buffer, int offset, int count) override
+	{
+		CheckOpen();
+
+		if(buffer == nullptr)
+			throw gcnew ArgumentNullException("buffer");
+		if(offset < 0 || count < 0 || offset > buffer->Length - count)
+			throw gcnew ArgumentOutOfRangeException("count");
+
+		if(_Position >= _Length || count == 0)
+			return 0;
+
+		count = static_cast<int>(Math::Min(static_cast<Int64>(count), _Length - _Position));
+
+		ulong ct;
+
+		if(_Position >= _BufferStart && _Position < _BufferStart + _BufferCt)
+		{
+			//already buffered
+			ct = Math::Min(static_cast<ulong>(count), static_cast<ulong>(_BufferStart + _BufferCt - _Position));
+			System::Runtime::InteropServices::Marshal::Copy(IntPtr(_Buffer + (_Position - _BufferStart)), buffer, offset, static_cast<int>(ct));
+		}
+		else if(static_cast<ulong>(count) >= ESEOBJECTS_LV_STREAM_BUFFER)
+		{
+			//large reads go straight to the caller's array
+			pin_ptr<uchar> dest = &buffer[offset];
+			ct = Fetch(_Position, dest, count);
+		}
+		else
+		{
+			if(!_Buffer)
+				_Buffer = new char[ESEOBJECTS_LV_STREAM_BUFFER];
+
+			_BufferCt = 0; //in case Fetch throws
+			_BufferStart = _Position;
+			_BufferCt = Fetch(_Position, _Buffer, ESEOBJECTS_LV_STREAM_BUFFER);
+
+			ct = Math::Min(static_cast<ulong>(count), _BufferCt);
+			System::Runtime::InteropServices::Marshal::Copy(IntPtr(_Buffer), buffer, offset, static_cast<int>(ct));
+		}
+
+		_Position += ct;
+		return static_cast<int>(ct);
+	}
+
+	virtual Int64 Seek(Int64 offset, System::IO::SeekOrigin origin) override
+	{
+		CheckOpen();
+
+		switch(origin)
+		{
+		case System::IO::SeekOrigin::Begin:
+			Position = offset;
+			break;
+		case System::IO::SeekOrigin::Current:
+			Position = _Position + offset;
+			break;
+		case System::IO::SeekOrigin::End:
+			Position = _Length + offset;
+			break;
+		default:
+			throw gcnew ArgumentException("Invalid SeekOrigin", "origin");
+		}
+
+		return _Position;
+	}
+
+	virtual void Flush() override
+	{}
+
+	virtual void SetLength(Int64) override
+	{
+		throw gcnew NotSupportedException("Long value reader streams are read only");
+	}
+
+	virtual void Write(array<uchar> ^, int, int) override
+	{
+		throw gcnew NotSupportedException("Long value reader streams are read only");
+	}
+};
+
+///<summary>Write only stream that sets one long value of the record being updated. Created by Cursor.Update.OpenLongValueWriter.</summary>
+private ref class LongValueWriter : public System::IO::Stream
+{
+	TableID ^_TableID;
+	JET_COLUMNID _ColID;
+	ulong _TagSequence;
+	Int64 _Written; //bytes set in the column so far
+	Int64 _Allocated; //size preallocated with JET_bitSetSizeLV, overwritten in place before appending
+
+	char *_Buffer; //ESEOBJECTS_LV_STREAM_BUFFER bytes, allocated on the first small write
+	ulong _BufferCt;
+
+	void CheckOpen()
+	{
+		if(!_TableID)
+			throw gcnew ObjectDisposedException("LongValueWriter");
+	}
+
+	void SetColumn(void *data, ulong cb, JET_GRBIT flags, ulong offset)
+	{
+		JET_SETINFO si = {sizeof si};
+
+		si.ibLongValue = offset;
+		si.itagSequence = _TagSequence;
+
+		EseException::RaiseOnError(JetSetColumn(_TableID->Session->_JetSesid, _TableID->_JetTableID, _ColID, data, cb, flags, &si));
+	}
+
+	//sets the next cb bytes of the value
+	void SetChunk(char *data, ulong cb)
+	{
+		if(_Written < _Allocated)
+		{
+			//overwrite the preallocated space first
+			ulong inplace = static_cast<ulong>(Math::Min(static_cast<Int64>(cb), _Allocated - _Written));
+
+			SetColumn(data, inplace, JET_bitSetOverwriteLV, static_cast<ulong>(_Written));
+			_Written += inplace;
+			data += inplace;
+			cb -= inplace;
+		}
+
+		if(cb)
+		{
+			//the first chunk of a value that wasn't preallocated replaces any existing value
+			SetColumn(data, cb, _Written ? JET_bitSetAppendLV : 0, 0);
+			_Written += cb;
+		}
+	}
+
+	void FlushBuffer()
+	{
+		if(_BufferCt)
+		{
+			SetChunk(_Buffer, _BufferCt);
+			_BufferCt = 0;
+		}
+	}
+
+internal:
+	LongValueWriter(TableID ^TabID, Column ^Col, Int64 ExpectedSize, ulong TagSequence) :
+		_TableID(TabID),
+		_ColID(0),
+		_TagSequence(TagSequence),
+		_Written(0),
+		_Allocated(0),
+		_Buffer(null),
+		_BufferCt(0)
+	{
+		if(Col == nullptr)
+			throw gcnew ArgumentNullException("Col");
+		if(ExpectedSize < 0 || ExpectedSize > Int32::MaxValue)
+			throw gcnew ArgumentOutOfRangeException("ExpectedSize");
+
+		_ColID = Col->_JetColID;
+
+		if(ExpectedSize)
+		{
+			SetColumn(null, static_cast<ulong>(ExpectedSize), JET_bitSetSizeLV, 0);
+			_Allocated = ExpectedSize;
+		}
+	}
+
+	//writes out buffered data and trims any unused preallocation; the stream can't be used afterward
+	void Finish()
+	{
+		if(!_TableID)
+			return;
+
+		try
+		{
+			FlushBuffer();
+
+			if(_Written < _Allocated)
+				SetColumn(null, static_cast<ulong>(_Written), JET_bitSetSizeLV, 0);
+			else if(_Written == 0)
+				SetColumn(null, 0, JET_bitSetZeroLength, 0);
+		}
+		finally
+		{
+			_TableID = nullptr;
+		}
+	}
+
+	//closes the stream without writing anything further, as when the update is canceled
+	void Abandon()
+	{
+		_TableID = nullptr;
+		_BufferCt = 0;
+	}
+
+public:
+	///<summary>Writes any buffered data and finishes the value.</summary>
+	~LongValueWriter()
+	{
+		try
+		{
+			Finish();
+		}
+		finally
+		{
+			this->!LongValueWriter();
+		}
+	}
+
+	!LongValueWriter()
+	{
+		delete[] _Buffer;
+		_Buffer = null;
+	}
+
+	virtual property bool CanRead {bool get() override {return false;}}
+	virtual property bool CanSeek {bool get() override {return false;}}
+	virtual property bool CanWrite {bool get() override {return _TableID != nullptr;}}
+
+	virtual property Int64 Length {Int64 get() override {CheckOpen(); return _Written + _BufferCt;}}
+
+	virtual property Int64 Position
+	{
+		Int64 get() override {CheckOpen(); return _Written + _BufferCt;}
+		void set(Int64) override {throw gcnew NotSupportedException("Long value writer streams can not seek");}
+	}
+
+	virtual void Write(array<uchar> ^buffer, int offset, int count) override
+	{
+		CheckOpen();
+
+		if(buffer == nullptr)
+			throw gcnew ArgumentNullException("buffer");
+		if(offset < 0 || count < 0 || offset > buffer->Length - count)
+			throw gcnew ArgumentOutOfRangeException("count");
+
+		if(count == 0)
+			return;
+
+		if(_BufferCt + count > ESEOBJECTS_LV_STREAM_BUFFER)
+			FlushBuffer();
+
+		if(static_cast<ulong>(count) >= ESEOBJECTS_LV_STREAM_BUFFER)
+		{
+			//large writes go straight from the caller's array
+			pin_ptr<uchar> src = &buffer[offset];
+			SetChunk(reinterpret_cast<char *>(static_cast<uchar *>(src)), count);
+			return;
+		}
+
+		if(!_Buffer)
+			_Buffer = new char[ESEOBJECTS_LV_STREAM_BUFFER];
+
+		System::Runtime::InteropServices::Marshal::Copy(buffer, offset, IntPtr(_Buffer + _BufferCt), count);
+		_BufferCt += count;
+	}
+
+	///<summary>Sets buffered data in the column. The value is still part of the pending update.</summary>
+	virtual void Flush() override
+	{
+		CheckOpen();
+		FlushBuffer();
+	}
+
+	virtual int Read(array<uchar> ^, int, int) override
+	{
+		throw gcnew NotSupportedException("Long value writer streams are write only");
+	}
+
+	virtual Int64 Seek(Int64, System::IO::SeekOrigin) override
+	{
+		throw gcnew NotSupportedException("Long value writer streams can not seek");
+	}
+
+	virtual void SetLength(Int64) override
+	{
+		throw gcnew NotSupportedException("Long value writer streams can not seek");
+	}
+};
@@ -2,7 +2,7 @@
 // Project     :  EseLinq http://code.google.com/p/eselinq/
 // Copyright   :  (c) 2009 Christopher Smith
 // Maintainer  :  csmith32@gmail.com
-// Module      :  free_list - Facility to free a list of heap allocated memory
+// Module      :  EseObjects.NativeAllocations - Counts of native allocations for temporary buffers
 ///////////////////////////////////////////////////////////////////////////////
 // 
 //This software is licenced under the terms of the MIT License:
@@ -29,75 +29,28 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-class free_list
+///<summary>
+///Counts of native heap allocations made for the temporary buffers used to convert values, such as by Update.Set and Key.
+///Totals since the process started, shared by all threads; take the difference over an operation to measure it.
+///</summary>
+public ref class NativeAllocations abstract sealed
 {
-	struct Entry
-	{
-		Entry *Next;
-		void *Item;
-		bool IsArray;
-
-		Entry(Entry *Next, void *Item, bool IsArray) :
-			Next(Next),
-			Item(Item),
-			IsArray(IsArray)
-		{}
-	}*Head;
-
-	void Push(void *Item, bool IsArray)
-	{
-		Entry *e = new Entry(Head, Item, IsArray);
-		Head = e;
-	}
-
 public:
-	free_list() :
-		Head(null)
-	{}
-
-	template <class T> T *alloc_zero()
+	///<summary>Blocks allocated from the heap: new pooled chunks and blocks too large for a chunk.</summary>
+	static property int HeapBlocks
 	{
-		T *x = new T;
-
-		memset(x, 0, sizeof(T));
-
-		Push(x, false);
-
-		return x;
+		int get() {return region_counters::HeapBlocks;}
 	}
 
-	template <class T> T *alloc_array(size_t ct)
+	///<summary>Blocks too large for a pooled chunk. Included in HeapBlocks.</summary>
+	static property int LargeBlocks
 	{
-		T *x = new T[ct];
-
-		Push(x, true);
-
-		return x;
+		int get() {return region_counters::LargeBlocks;}
 	}
 
-	template <class T> T *alloc_array_zero(size_t ct)
+	///<summary>Chunks taken from the pool, whether reused or newly allocated. Allocations that fit in a region's inline storage take none.</summary>
+	static property int ChunksTaken
 	{
-		T *x = new T[ct];
-
-		memset(x, 0, sizeof(T) * ct);
-
-		Push(x, true);
-
-		return x;
-	}
-
-	~free_list()
-	{
-		while(Head)
-		{
-			Entry *e = Head;
-			Head = e->Next;
-
-			if(e->IsArray)
-				delete[] e->Item;
-			else
-				delete e->Item;
-			delete e;
-		}
+		int get() {return region_counters::ChunksTaken;}
 	}
-};
\ No newline at end of file
+};
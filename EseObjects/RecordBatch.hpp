@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  EseObjects.RecordBatch - Column oriented storage of rows read by Cursor.ReadRecordBatch
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma managed(push, off)
+
+//copies the values of column col of the first rows rows of b into dest, one elem_size element per row
+//null values are zeroed and flagged in nulls, one bit per row
+void batch_gather_fixed(batch_buffer const &b, ulong rows, ulong col, char *dest, ulong elem_size, ulong *nulls)
+{
+	for(ulong r = 0; r < rows; r++)
+	{
+		batch_value const &v = b.Values[r * b.ColCt + col];
+		char *elem = dest + r * elem_size;
+
+		if(v.Err == JET_wrnColumnNull)
+		{
+			nulls[r / 32] |= 1UL << (r % 32);
+			memset(elem, 0, elem_size);
+		}
+		else
+		{
+			ulong sz = min(v.Size, elem_size);
+
+			memcpy(elem, b.Data + v.Offset, sz);
+			memset(elem + sz, 0, elem_size - sz);
+		}
+	}
+}
+
+//as batch_gather_fixed, but for Bit columns: ESE stores true as 0xFF, which is normalized to 1
+void batch_gather_bit(batch_buffer const &b, ulong rows, ulong col, bool *dest, ulong *nulls)
+{
+	for(ulong r = 0; r < rows; r++)
+	{
+		batch_value const &v = b.Values[r * b.ColCt + col];
+
+		if(v.Err == JET_wrnColumnNull)
+		{
+			nulls[r / 32] |= 1UL << (r % 32);
+			dest[r] = false;
+		}
+		else
+			dest[r] = v.Size > 0 && b.Data[v.Offset] != 0;
+	}
+}
+
+//total bytes needed to hold the values of column col of the first rows rows of b back to back
+ulong batch_var_size(batch_buffer const &b, ulong rows, ulong col)
+{
+	ulong total = 0;
+
+	for(ulong r = 0; r < rows; r++)
+	{
+		batch_value const &v = b.Values[r * b.ColCt + col];
+
+		if(v.Err != JET_wrnColumnNull)
+			total += v.Size;
+	}
+
+	return total;
+}
+
+//copies the values of column col of the first rows rows of b back to back into dest
+//offsets receives rows + 1 entries, counted in elem_size units; the value of row r spans offsets[r] to offsets[r + 1]
+//null values are empty and flagged in nulls, one bit per row
+void batch_gather_var(batch_buffer const &b, ulong rows, ulong col, char *dest, ulong elem_size, int *offsets, ulong *nulls)
+{
+	ulong pos = 0;
+
+	offsets[0] = 0;
+
+	for(ulong r = 0; r < rows; r++)
+	{
+		batch_value const &v = b.Values[r * b.ColCt + col];
+
+		if(v.Err == JET_wrnColumnNull)
+			nulls[r / 32] |= 1UL << (r % 32);
+		else
+		{
+			ulong sz = v.Size - v.Size % elem_size;
+
+			memcpy(dest + pos, b.Data + v.Offset, sz);
+			pos += sz;
+		}
+
+		offsets[r + 1] = pos / elem_size;
+	}
+}
+
+#pragma managed(pop)
+
+///<summary>
+///Column oriented storage for the rows read by one call of Cursor.ReadRecordBatch.
+///Each column of the batch is held in one array, chosen from the column type, so values can be processed in tight loops without boxing:<pr/>
+///Fixed size columns use an array of the equivalent primitive type with one element per row: Bit as Boolean, UnsignedByte as Byte, Short as Int16, UnsignedShort as UInt16, Long as Int32, UnsignedLong as UInt32, Currency and LongLong as Int64, SingleFloat as Single, DoubleFloat as Double, GUID as Guid.
+///DateTime columns are kept as Double in the OLE automation date form ESE stores; use DateTime.FromOADate to convert.<pr/>
+///Unicode Text and LongText columns use one Char array holding all values back to back, other Text, Binary and LongBinary columns likewise use one Byte array.
+///GetOffsets returns where each value starts and ends in that array.<pr/>
+///Each column also has a null bitmap, see GetNullBitmap.
+///</summary>
+///<remarks>Arrays are reused by later calls when large enough, so values should be copied out before reading the next batch. Holds native memory. Dispose when no longer needed.
+///<pr/>Values are the bytes as stored: values of columns compressed with Column.CompressionThreshold are not expanded, so read those with Retrieve instead.
+///</remarks>
+public ref class RecordBatch
+{
+internal:
+	RowBatch ^_Rows;
+	ColumnSet ^_Columns; //columns the vectors were allocated for
+	array<Array ^> ^_Values;
+	array<array<int> ^> ^_Offsets; //null for fixed size columns
+	array<array<ulong> ^> ^_Nulls;
+	int _Capacity;
+	int _Count;
+
+	static bool IsVariable(Column ^Col)
+	{
+		switch(Col->_JetColTyp)
+		{
+		case JET_coltypBinary:
+		case JET_coltypText:
+		case JET_coltypLongBinary:
+		case JET_coltypLongText:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static bool IsUnicode(Column ^Col)
+	{
+		return (Col->_JetColTyp == JET_coltypText || Col->_JetColTyp == JET_coltypLongText) && Col->_CP == 1200;
+	}
+
+	static Type ^ElementType(Column ^Col)
+	{
+		switch(Col->_JetColTyp)
+		{
+		case JET_coltypBit: return Boolean::typeid;
+		case JET_coltypUnsignedByte: return Byte::typeid;
+		case JET_coltypShort: return Int16::typeid;
+		case JET_coltypUnsignedShort: return UInt16::typeid;
+		case JET_coltypLong: return Int32::typeid;
+		case JET_coltypUnsignedLong: return UInt32::typeid;
+		case JET_coltypCurrency: return Int64::typeid;
+		case JET_coltypLongLong: return Int64::typeid;
+		case JET_coltypIEEESingle: return Single::typeid;
+		case JET_coltypIEEEDouble: return Double::typeid;
+		case JET_coltypDateTime: return Double::typeid;
+		case JET_coltypGUID: return Guid::typeid;
+		case JET_coltypBinary:
+		case JET_coltypLongBinary:
+			return Byte::typeid;
+		case JET_coltypText:
+		case JET_coltypLongText:
+			return IsUnicode(Col) ? Char::typeid : Byte::typeid;
+		default:
+			throw gcnew ArgumentException("Unsupported column type " + Col->ColumnType.ToString() + " for column " + Col->Name);
+		}
+	}
+
+	template <class T> void GatherFixed(int c)
+	{
+		array<T> ^vec = safe_cast<array<T> ^>(_Values[c]);
+		pin_ptr<T> dest = &vec[0];
+		pin_ptr<ulong> nulls = &_Nulls[c][0];
+
+		batch_gather_fixed(*_Rows->_Buffer, _Count, c, reinterpret_cast<char *>(static_cast<T *>(dest)), sizeof(T), nulls);
+	}
+
+	template <class T> void GatherVariable(int c)
+	{
+		ulong total = batch_var_size(*_Rows->_Buffer, _Count, c);
+		ulong ct = total / sizeof(T);
+		array<T> ^vec = safe_cast<array<T> ^>(_Values[c]);
+
+		if(vec == nullptr || static_cast<ulong>(vec->Length) < ct)
+			_Values[c] = vec = gcnew array<T>(ct > 0 ? ct : 1); //never empty so it can be pinned
+
+		pin_ptr<T> dest = &vec[0];
+		pin_ptr<int> offsets = &_Offsets[c][0];
+		pin_ptr<ulong> nulls = &_Nulls[c][0];
+
+		batch_gather_var(*_Rows->_Buffer, _Count, c, reinterpret_cast<char *>(static_cast<T *>(dest)), sizeof(T), offsets, nulls);
+	}
+
+	//(re)allocates the vectors if the columns changed or there are more rows than before
+	void Allocate(ColumnSet ^Cols, int Rows)
+	{
+		if(Object::ReferenceEquals(Cols, _Columns) && Rows <= _Capacity)
+		{
+			for(int c = 0; c < _Nulls->Length; c++)
+				Array::Clear(_Nulls[c], 0, _Nulls[c]->Length);
+			return;
+		}
+
+		int ct = Cols->Count;
+
+		_Values = gcnew array<Array ^>(ct);
+		_Offsets = gcnew array<array<int> ^>(ct);
+		_Nulls = gcnew array<array<ulong> ^>(ct);
+
+		for(int c = 0; c < ct; c++)
+		{
+			Column ^Col = Cols->_Columns[c];
+			Type ^ElemType = ElementType(Col);
+
+			_Nulls[c] = gcnew array<ulong>((Rows + 31) / 32);
+
+			if(IsVariable(Col))
+				_Offsets[c] = gcnew array<int>(Rows + 1); //data array allocated on demand to fit
+			else
+				_Values[c] = Array::CreateInstance(ElemType, Rows);
+		}
+
+		_Columns = Cols;
+		_Capacity = Rows;
+	}
+
+	//converts the rows just read into _Rows to columns
+	void Load()
+	{
+		_Count = _Rows->_Count;
+
+		if(_Count == 0)
+			return;
+
+		Allocate(_Rows->_Columns, _Count);
+
+		for(int c = 0; c < _Columns->Count; c++)
+		{
+			Column ^Col = _Columns->_Columns[c];
+
+			switch(Col->_JetColTyp)
+			{
+			case JET_coltypBit:
+				{
+					array<bool> ^vec = safe_cast<array<bool> ^>(_Values[c]);
+					pin_ptr<bool> dest = &vec[0];
+					pin_ptr<ulong> nulls = &_Nulls[c][0];
+
+					batch_gather_bit(*_Rows->_Buffer, _Count, c, dest, nulls);
+				}
+				break;
+			case JET_coltypUnsignedByte: GatherFixed<uchar>(c); break;
+			case JET_coltypShort: GatherFixed<short>(c); break;
+			case JET_coltypUnsignedShort: GatherFixed<ushort>(c); break;
+			case JET_coltypLong: GatherFixed<long>(c); break;
+			case JET_coltypUnsignedLong: GatherFixed<ulong>(c); break;
+			case JET_coltypCurrency: GatherFixed<Int64>(c); break;
+			case JET_coltypLongLong: GatherFixed<Int64>(c); break;
+			case JET_coltypIEEESingle: GatherFixed<float>(c); break;
+			case JET_coltypIEEEDouble: GatherFixed<double>(c); break;
+			case JET_coltypDateTime: GatherFixed<double>(c); break;
+			case JET_coltypGUID: GatherFixed<Guid>(c); break;
+			default:
+				if(IsUnicode(Col))
+					GatherVariable<wchar_t>(c);
+				else
+					GatherVariable<uchar>(c);
+			}
+		}
+	}
+
+	void CheckColumn(int Col)
+	{
+		if(_Columns == nullptr || Col < 0 || Col >= _Columns->Count)
+			throw gcnew ArgumentOutOfRangeException("Col");
+	}
+
+	void CheckRow(int Row)
+	{
+		if(Row < 0 || Row >= _Count)
+			throw gcnew ArgumentOutOfRangeException("Row");
+	}
+
+public:
+	RecordBatch() :
+		_Rows(gcnew RowBatch),
+		_Columns(nullptr),
+		_Values(nullptr),
+		_Offsets(nullptr),
+		_Nulls(nullptr),
+		_Capacity(0),
+		_Count(0)
+	{}
+
+	~RecordBatch()
+	{
+		delete _Rows;
+	}
+
+	///<summary>Number of rows read by the last ReadRecordBatch call.</summary>
+	property int Count {int get() {return _Count;}}
+
+	///<summary>Columns read by the last ReadRecordBatch call.</summary>
+	property ColumnSet ^Columns {ColumnSet ^get() {return _Columns;}}
+
+	///<summary>True if the last ReadRecordBatch call stopped because there were no more records in the index or range.</summary>
+	property bool EndReached {bool get() {return _Rows->_EndReached;}}
+
+	///<summary>Element type of the array returned by GetValues for a column.</summary>
+	Type ^ElementTypeOf(int Col)
+	{
+		CheckColumn(Col);
+		return ElementType(_Columns->_Columns[Col]);
+	}
+
+	///<summary>
+	///Array holding the values of a column. For fixed size columns, element N is the value of row N.
+	///For variable size columns, the values of all rows back to back; see GetOffsets.
+	///Only the first Count elements (or up to the last offset) are meaningful, the array may be longer.
+	///</summary>
+	///<typeparam name="T">Must match ElementTypeOf(Col), otherwise InvalidCastException is thrown.</typeparam>
+	generic <class T> array<T> ^GetValues(int Col)
+	{
+		CheckColumn(Col);
+		return safe_cast<array<T> ^>(_Values[Col]);
+	}
+
+	///<summary>
+	///For variable size columns, Count + 1 positions in the array returned by GetValues, counted in elements.
+	///The value of row N spans from element GetOffsets(Col)[N] up to but not including GetOffsets(Col)[N + 1].
+	///Null for fixed size columns.
+	///</summary>
+	array<int> ^GetOffsets(int Col)
+	{
+		CheckColumn(Col);
+		return _Offsets[Col];
+	}
+
+	///<summary>Null bitmap of a column. Bit N % 32 of element N / 32 is set if the value of row N is null.</summary>
+	array<ulong> ^GetNullBitmap(int Col)
+	{
+		CheckColumn(Col);
+		return _Nulls[Col];
+	}
+
+	///<summary>True if the specified value was null.</summary>
+	bool IsNull(int Row, int Col)
+	{
+		CheckColumn(Col);
+		CheckRow(Row);
+		return (_Nulls[Col][Row / 32] & (1U << (Row % 32))) != 0;
+	}
+
+	///<summary>Value of a Text or LongText column as a string. Null if the value was null. Compressed values are not expanded, see the class remarks.</summary>
+	String ^GetString(int Row, int Col)
+	{
+		if(IsNull(Row, Col))
+			return nullptr;
+
+		Column ^C = _Columns->_Columns[Col];
+		array<int> ^Offsets = _Offsets[Col];
+
+		if(C->_JetColTyp != JET_coltypText && C->_JetColTyp != JET_coltypLongText)
+			throw gcnew InvalidOperationException("Column " + C->Name + " is not a text column");
+
+		if(IsUnicode(C))
+			return gcnew String(safe_cast<array<wchar_t> ^>(_Values[Col]), Offsets[Row], Offsets[Row + 1] - Offsets[Row]);
+		else
+			return System::Text::Encoding::ASCII->GetString(safe_cast<array<uchar> ^>(_Values[Col]), Offsets[Row], Offsets[Row + 1] - Offsets[Row]);
+	}
+
+	///<summary>Copy of the value of a Text, Binary, LongText or LongBinary column. Null if the value was null. Compressed values are not expanded, see the class remarks.</summary>
+	array<uchar> ^GetBytes(int Row, int Col)
+	{
+		if(IsNull(Row, Col))
+			return nullptr;
+
+		if(_Offsets[Col] == nullptr)
+			throw gcnew InvalidOperationException("Column " + _Columns->_Columns[Col]->Name + " is not a variable size column");
+
+		array<int> ^Offsets = _Offsets[Col];
+		Array ^Src = _Values[Col];
+		int ElemSize = IsUnicode(_Columns->_Columns[Col]) ? 2 : 1;
+		array<uchar> ^Ret = gcnew array<uchar>((Offsets[Row + 1] - Offsets[Row]) * ElemSize);
+
+		System::Buffer::BlockCopy(Src, Offsets[Row] * ElemSize, Ret, 0, Ret->Length);
+
+		return Ret;
+	}
+};
@@ -0,0 +1,381 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  EseObjects.RecordCopy - Native record copying between cursors
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma managed(push, off)
+
+//native state for Cursor.CopyRecordsTo
+//holds the values of one source record, all in one data block, and the JET_SETCOLUMN array to insert them with
+class record_copier
+{
+	//not copyable, owns all arrays
+	record_copier(record_copier const &);
+	record_copier &operator=(record_copier const &);
+
+	ulong DataCap;
+	ulong ValueCap;
+
+	//makes room for ct more bytes at DataUsed, preserving what's there
+	char *reserve(ulong ct)
+	{
+		if(DataUsed + ct > DataCap)
+		{
+			ulong NewCap = DataCap ? DataCap : 0x1000;
+
+			while(NewCap < DataUsed + ct)
+				NewCap *= 2;
+
+			char *NewData = new char[NewCap];
+
+			if(DataUsed)
+				memcpy(NewData, Data, DataUsed);
+
+			delete[] Data;
+			Data = NewData;
+			DataCap = NewCap;
+		}
+
+		return Data + DataUsed;
+	}
+
+	//adds a value to set; pvData is filled in by write_row since Data may move until then
+	void add_value(ulong col, ulong offset, ulong size, ulong tag)
+	{
+		if(SetCt == ValueCap)
+		{
+			ulong NewCap = ValueCap ? ValueCap * 2 : ColCt + 8;
+			JET_SETCOLUMN *NewJsc = new JET_SETCOLUMN[NewCap];
+			ulong *NewOffsets = new ulong[NewCap];
+
+			memcpy(NewJsc, Jsc, SetCt * sizeof *Jsc);
+			memcpy(NewOffsets, Offsets, SetCt * sizeof *Offsets);
+
+			delete[] Jsc;
+			delete[] Offsets;
+			Jsc = NewJsc;
+			Offsets = NewOffsets;
+			ValueCap = NewCap;
+		}
+
+		JET_SETCOLUMN &jsc = Jsc[SetCt];
+
+		memset(&jsc, 0, sizeof jsc);
+		jsc.columnid = DestIDs[col];
+		jsc.cbData = size;
+		jsc.grbit = size ? 0 : JET_bitSetZeroLength;
+		jsc.itagSequence = tag == 1 ? 1 : 0; //zero adds further values of a multivalued column
+		Offsets[SetCt] = offset;
+		SetCt++;
+	}
+
+	//retrieves one value of a column into Data starting with a cb byte buffer, adding it to the values to set
+	//returns JET_wrnColumnNull if there is no such value
+	JET_ERR retrieve_value(JET_SESID sesid, JET_TABLEID tableid, ulong col, ulong tag, ulong cb)
+	{
+		JET_RETINFO ret_info = {sizeof ret_info};
+		ulong actual = 0;
+		ulong offset = DataUsed;
+
+		ret_info.itagSequence = tag;
+
+		JET_ERR err = JetRetrieveColumn(sesid, tableid, SrcIDs[col], reserve(cb), cb, &actual, 0, &ret_info);
+
+		if(err == JET_wrnBufferTruncated)
+		{
+			cb = actual;
+			err = JetRetrieveColumn(sesid, tableid, SrcIDs[col], reserve(cb), cb, &actual, 0, &ret_info);
+		}
+
+		if(err == JET_wrnColumnNull || err < JET_errSuccess)
+			return err;
+
+		DataUsed += cb;
+		add_value(col, offset, min(actual, cb), tag);
+
+		return JET_errSuccess;
+	}
+
+public:
+	ulong ColCt;
+	JET_COLUMNID *SrcIDs;
+	JET_COLUMNID *DestIDs;
+	bool *MultiValued;
+	ulong *Sizes; //preallocated size for each column
+	ulong RowSize; //sum of Sizes
+	JET_RETRIEVECOLUMN *Jrc;
+
+	JET_SETCOLUMN *Jsc;
+	ulong *Offsets; //of each Jsc value in Data
+	ulong SetCt;
+
+	char *Data;
+	ulong DataUsed;
+
+	record_copier() :
+		DataCap(0),
+		ValueCap(0),
+		ColCt(0),
+		SrcIDs(null),
+		DestIDs(null),
+		MultiValued(null),
+		Sizes(null),
+		RowSize(0),
+		Jrc(null),
+		Jsc(null),
+		Offsets(null),
+		SetCt(0),
+		Data(null),
+		DataUsed(0)
+	{}
+
+	~record_copier()
+	{
+		delete[] SrcIDs;
+		delete[] DestIDs;
+		delete[] MultiValued;
+		delete[] Sizes;
+		delete[] Jrc;
+		delete[] Jsc;
+		delete[] Offsets;
+		delete[] Data;
+	}
+
+	//allocates the per column arrays for col_ct columns, to be filled in by the caller
+	void set_columns(ulong col_ct)
+	{
+		ColCt = col_ct;
+		SrcIDs = new JET_COLUMNID[col_ct];
+		DestIDs = new JET_COLUMNID[col_ct];
+		MultiValued = new bool[col_ct];
+		Sizes = new ulong[col_ct];
+		Jrc = new JET_RETRIEVECOLUMN[col_ct];
+		RowSize = 0;
+	}
+
+	//retrieves every value of the mapped columns of the current record
+	//the first value of each column is retrieved with one JetRetrieveColumns call, further values of multivalued columns one at a time
+	JET_ERR read_row(JET_SESID sesid, JET_TABLEID tableid)
+	{
+		DataUsed = 0;
+		SetCt = 0;
+
+		char *row = reserve(RowSize);
+
+		for(ulong c = 0, off = 0; c < ColCt; off += Sizes[c], c++)
+		{
+			memset(&Jrc[c], 0, sizeof Jrc[c]);
+			Jrc[c].columnid = SrcIDs[c];
+			Jrc[c].pvData = row + off;
+			Jrc[c].cbData = Sizes[c];
+			Jrc[c].itagSequence = 1;
+		}
+
+		JET_ERR err = JetRetrieveColumns(sesid, tableid, Jrc, ColCt);
+
+		if(err < JET_errSuccess)
+			return err;
+
+		DataUsed = RowSize;
+
+		for(ulong c = 0, off = 0; c < ColCt; off += Sizes[c], c++)
+		{
+			switch(Jrc[c].err)
+			{
+			case JET_wrnColumnNull:
+				continue; //nothing to set, and no further values
+
+			case JET_errSuccess:
+				add_value(c, off, Jrc[c].cbActual, 1);
+				break;
+
+			case JET_wrnBufferTruncated:
+				err = retrieve_value(sesid, tableid, c, 1, Jrc[c].cbActual);
+				if(err < JET_errSuccess)
+					return err;
+				break;
+
+			default:
+				return Jrc[c].err;
+			}
+
+			if(MultiValued[c])
+				for(ulong tag = 2; ; tag++)
+				{
+					err = retrieve_value(sesid, tableid, c, tag, Sizes[c]);
+
+					if(err == JET_wrnColumnNull)
+						break;
+					if(err < JET_errSuccess)
+						return err;
+				}
+		}
+
+		return JET_errSuccess;
+	}
+
+	//inserts a record with the values from the last read_row
+	JET_ERR write_row(JET_SESID sesid, JET_TABLEID tableid)
+	{
+		for(ulong i = 0; i < SetCt; i++)
+			Jsc[i].pvData = Data + Offsets[i];
+
+		JET_ERR err = JetPrepareUpdate(sesid, tableid, JET_prepInsert);
+
+		if(err < JET_errSuccess)
+			return err;
+
+		if(SetCt)
+		{
+			err = JetSetColumns(sesid, tableid, Jsc, SetCt);
+
+			for(ulong i = 0; i < SetCt && err >= JET_errSuccess; i++)
+				if(Jsc[i].err < JET_errSuccess)
+					err = Jsc[i].err;
+		}
+
+		if(err >= JET_errSuccess)
+			err = JetUpdate(sesid, tableid, null, 0, null);
+
+		if(err < JET_errSuccess)
+			JetPrepareUpdate(sesid, tableid, JET_prepCancel);
+
+		return err;
+	}
+};
+
+//inserts into dest the record last read by rc.read_row, then moves src forward, reading and inserting each following record until limit have been inserted
+//more is set to false if src ran out of records, otherwise src is left on the first record not copied, which has not been read yet
+//the caller manages the transaction around each batch, so it knows whether to continue before committing
+JET_ERR copy_batch(record_copier &rc, JET_SESID src_sesid, JET_TABLEID src, JET_SESID dest_sesid, JET_TABLEID dest, ulong limit, ulong &written, bool &more)
+{
+	written = 0;
+	more = true;
+
+	for(;;)
+	{
+		JET_ERR err = rc.write_row(dest_sesid, dest);
+
+		if(err < JET_errSuccess)
+			return err;
+
+		written++;
+
+		err = JetMove(src_sesid, src, JET_MoveNext, 0);
+
+		if(err == JET_errNoCurrentRecord)
+		{
+			more = false;
+			return JET_errSuccess;
+		}
+
+		if(err < JET_errSuccess || written == limit)
+			return err;
+
+		err = rc.read_row(src_sesid, src);
+
+		if(err < JET_errSuccess)
+			return err;
+	}
+}
+
+#pragma managed(pop)
+
+///<summary>
+///Pairs of source and destination columns for Cursor.CopyRecordsTo.
+///There are no disposable resources associated with an instance of this class.
+///</summary>
+public ref class ColumnMapping
+{
+internal:
+	List<Column ^> ^_Source;
+	List<Column ^> ^_Dest;
+
+	void Load(record_copier &rc)
+	{
+		ulong ct = _Source->Count;
+
+		rc.set_columns(ct);
+
+		for(ulong i = 0; i < ct; i++)
+		{
+			rc.SrcIDs[i] = _Source[i]->_JetColID;
+			rc.DestIDs[i] = _Dest[i]->_JetColID;
+			rc.MultiValued[i] = _Source[i]->MultiValued;
+			rc.Sizes[i] = ColumnSet::InitialBufferSize(_Source[i]);
+			rc.RowSize += rc.Sizes[i];
+		}
+	}
+
+public:
+	ColumnMapping() :
+		_Source(gcnew List<Column ^>),
+		_Dest(gcnew List<Column ^>)
+	{}
+
+	///<summary>Copies the values of the Source column into the Dest column.</summary>
+	void Add(Column ^Source, Column ^Dest)
+	{
+		if(Source == nullptr)
+			throw gcnew ArgumentNullException("Source");
+		if(Dest == nullptr)
+			throw gcnew ArgumentNullException("Dest");
+
+		_Source->Add(Source);
+		_Dest->Add(Dest);
+	}
+
+	///<summary>Number of column pairs.</summary>
+	property int Count {int get() {return _Source->Count;}}
+
+	///<summary>Maps each column in Source to the column in Dest with the same name, ignoring case. Columns without a match are left out.</summary>
+	///<remarks>For example, ColumnMapping.ByName(src.ColumnMap.Values, dest.ColumnMap.Values) maps all like named columns of two tables.</remarks>
+	static ColumnMapping ^ByName(IEnumerable<Column ^> ^Source, IEnumerable<Column ^> ^Dest)
+	{
+		if(Source == nullptr)
+			throw gcnew ArgumentNullException("Source");
+		if(Dest == nullptr)
+			throw gcnew ArgumentNullException("Dest");
+
+		Dictionary<String ^, Column ^> ^DestByName = gcnew Dictionary<String ^, Column ^>(StringComparer::OrdinalIgnoreCase);
+
+		for each(Column ^C in Dest)
+			DestByName[C->Name] = C;
+
+		ColumnMapping ^Map = gcnew ColumnMapping;
+		Column ^Match;
+
+		for each(Column ^C in Source)
+			if(DestByName->TryGetValue(C->Name, Match))
+				Map->Add(C, Match);
+
+		return Map;
+	}
+};
@@ -0,0 +1,349 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  EseObjects.RowBatch - Multiple rows retrieved by one call to Cursor.ReadBatch
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//the batch read loop is compiled as native code so a whole batch is read with a single managed to native transition
+#pragma managed(push, off)
+
+//location of one column value of one row within batch_buffer::Data
+struct batch_value
+{
+	ulong Offset;
+	ulong Size;
+	JET_ERR Err; //JET_errSuccess or JET_wrnColumnNull
+};
+
+//native storage for a RowBatch: the columns to read, and the values of each row read
+//values of all rows are stored in one data block, each row at a fixed stride with oversized values appended after their row
+class batch_buffer
+{
+	//not copyable, owns all arrays
+	batch_buffer(batch_buffer const &);
+	batch_buffer &operator=(batch_buffer const &);
+
+	ulong ValueCap;
+	ulong DataCap;
+
+	//makes room for ct more bytes at DataUsed, preserving what's there
+	char *append(ulong ct)
+	{
+		if(DataUsed + ct > DataCap)
+		{
+			ulong NewCap = DataCap ? DataCap : 0x1000;
+
+			while(NewCap < DataUsed + ct)
+				NewCap *= 2;
+
+			char *NewData = new char[NewCap];
+
+			if(DataUsed)
+				memcpy(NewData, Data, DataUsed);
+
+			delete[] Data;
+			Data = NewData;
+			DataCap = NewCap;
+		}
+
+		return Data + DataUsed;
+	}
+
+	//makes room for the values of row, preserving those of the rows before it
+	//grows geometrically up to the values of max_rows, so a large cap costs nothing until rows are actually read
+	void reserve_row(ulong row, ulong max_rows)
+	{
+		ulong need = (row + 1) * ColCt;
+
+		if(need <= ValueCap)
+			return;
+
+		ulong NewCap = ValueCap ? ValueCap : 0x40 * ColCt;
+		ulong MaxCap = max_rows * ColCt;
+
+		while(NewCap < need)
+			NewCap = NewCap > MaxCap / 2 ? MaxCap : NewCap * 2;
+
+		if(NewCap > MaxCap)
+			NewCap = MaxCap;
+
+		batch_value *NewValues = new batch_value[NewCap];
+
+		if(row)
+			memcpy(NewValues, Values, row * ColCt * sizeof *Values);
+
+		delete[] Values;
+		Values = NewValues;
+		ValueCap = NewCap;
+	}
+
+public:
+	ulong ColCt;
+	JET_COLUMNID *ColIDs;
+	ulong *Sizes; //preallocated size for each column in a row
+	ulong RowSize; //sum of Sizes
+	JET_RETRIEVECOLUMN *Jrc;
+
+	batch_value *Values; //ColCt per row
+	char *Data;
+	ulong DataUsed;
+
+	batch_buffer() :
+		ValueCap(0),
+		DataCap(0),
+		ColCt(0),
+		ColIDs(null),
+		Sizes(null),
+		RowSize(0),
+		Jrc(null),
+		Values(null),
+		Data(null),
+		DataUsed(0)
+	{}
+
+	~batch_buffer()
+	{
+		delete[] ColIDs;
+		delete[] Sizes;
+		delete[] Jrc;
+		delete[] Values;
+		delete[] Data;
+	}
+
+	//allocates the per column arrays for col_ct columns, to be filled in by the caller
+	void set_columns(ulong col_ct)
+	{
+		delete[] ColIDs;
+		delete[] Sizes;
+		delete[] Jrc;
+
+		ColCt = col_ct;
+		ColIDs = new JET_COLUMNID[col_ct];
+		Sizes = new ulong[col_ct];
+		Jrc = new JET_RETRIEVECOLUMN[col_ct];
+		RowSize = 0;
+	}
+
+	//reads up to max_rows rows starting at the current record, moving to the next record after each
+	//max_rows * ColCt must not overflow; the caller checks
+	//stops early with status set if a retrieve or move fails; JET_errNoCurrentRecord indicates the end of the index or range
+	//returns the number of complete rows read
+	ulong read(JET_SESID sesid, JET_TABLEID tableid, ulong max_rows, JET_ERR &status)
+	{
+		status = JET_errSuccess;
+		DataUsed = 0;
+
+		ulong rows = 0;
+
+		while(rows < max_rows)
+		{
+			reserve_row(rows, max_rows);
+
+			ulong base = DataUsed;
+			char *row = append(RowSize);
+			batch_value *vals = Values + rows * ColCt;
+
+			for(ulong c = 0, off = 0; c < ColCt; off += Sizes[c], c++)
+			{
+				memset(&Jrc[c], 0, sizeof Jrc[c]);
+				Jrc[c].columnid = ColIDs[c];
+				Jrc[c].pvData = row + off;
+				Jrc[c].cbData = Sizes[c];
+				Jrc[c].itagSequence = 1;
+
+				vals[c].Offset = base + off;
+			}
+
+			JET_ERR err = JetRetrieveColumns(sesid, tableid, Jrc, ColCt);
+
+			if(err < JET_errSuccess)
+			{
+				status = err;
+				break;
+			}
+
+			DataUsed += RowSize;
+
+			for(ulong c = 0; c < ColCt; c++)
+			{
+				vals[c].Size = Jrc[c].cbActual;
+				vals[c].Err = Jrc[c].err;
+
+				if(Jrc[c].err == JET_wrnBufferTruncated)
+				{
+					//retrieve again into space after the row
+					ulong need = Jrc[c].cbActual;
+					ulong actual = 0;
+					char *extra = append(need);
+
+					err = JetRetrieveColumn(sesid, tableid, ColIDs[c], extra, need, &actual, 0, null);
+
+					if(err < JET_errSuccess)
+					{
+						status = err;
+						return rows;
+					}
+
+					vals[c].Offset = DataUsed;
+					vals[c].Size = min(actual, need);
+					vals[c].Err = JET_errSuccess;
+					DataUsed += need;
+				}
+				else if(Jrc[c].err != JET_errSuccess && Jrc[c].err != JET_wrnColumnNull)
+				{
+					status = Jrc[c].err;
+					return rows;
+				}
+			}
+
+			rows++;
+
+			err = JetMove(sesid, tableid, JET_MoveNext, 0);
+
+			if(err < JET_errSuccess)
+			{
+				status = err;
+				break;
+			}
+		}
+
+		return rows;
+	}
+};
+
+#pragma managed(pop)
+
+///<summary>
+///Reusable buffer holding the rows read by one call of Cursor.ReadBatch.
+///Values are kept in their raw form and converted with the cursor's Bridge when accessed.
+///</summary>
+///<remarks>Holds native memory. Dispose when no longer needed, or reuse for further calls to ReadBatch.</remarks>
+public ref class RowBatch
+{
+internal:
+	batch_buffer *_Buffer;
+	ColumnSet ^_Columns;
+	EseObjects::Bridge ^_Bridge;
+	int _Count;
+	bool _EndReached;
+
+	//sets up the native column arrays, unless they were already set up for this ColumnSet
+	void Prepare(ColumnSet ^Cols)
+	{
+		if(!_Buffer)
+			throw gcnew ObjectDisposedException("RowBatch");
+
+		_Count = 0;
+
+		if(Object::ReferenceEquals(Cols, _Columns))
+			return;
+
+		ulong ct = Cols->_Columns->Length;
+
+		_Buffer->set_columns(ct);
+		_Columns = Cols;
+
+		for(ulong i = 0; i < ct; i++)
+		{
+			_Buffer->ColIDs[i] = Cols->_Columns[i]->_JetColID;
+			_Buffer->Sizes[i] = Cols->_BufferSizes[i];
+			_Buffer->RowSize += Cols->_BufferSizes[i];
+		}
+	}
+
+	batch_value &ValueAt(int Row, int Col)
+	{
+		if(Row < 0 || Row >= _Count)
+			throw gcnew ArgumentOutOfRangeException("Row");
+		if(Col < 0 || Col >= _Columns->Count)
+			throw gcnew ArgumentOutOfRangeException("Col");
+
+		return _Buffer->Values[Row * _Buffer->ColCt + Col];
+	}
+
+public:
+	RowBatch() :
+		_Buffer(new batch_buffer),
+		_Columns(nullptr),
+		_Bridge(nullptr),
+		_Count(0),
+		_EndReached(false)
+	{}
+
+	~RowBatch()
+	{
+		this->!RowBatch();
+	}
+
+	!RowBatch()
+	{
+		delete _Buffer;
+		_Buffer = null;
+	}
+
+	///<summary>Number of rows read by the last ReadBatch call.</summary>
+	property int Count {int get() {return _Count;}}
+
+	///<summary>Columns read by the last ReadBatch call.</summary>
+	property ColumnSet ^Columns {ColumnSet ^get() {return _Columns;}}
+
+	///<summary>True if the last ReadBatch call stopped because there were no more records in the index or range.</summary>
+	property bool EndReached {bool get() {return _EndReached;}}
+
+	///<summary>True if the specified value was null.</summary>
+	bool IsNull(int Row, int Col)
+	{
+		return ValueAt(Row, Col).Err == JET_wrnColumnNull;
+	}
+
+	///<summary>Converts the specified value to the type given for its column in the ColumnSet.</summary>
+	Object ^GetValue(int Row, int Col)
+	{
+		batch_value &v = ValueAt(Row, Col);
+		Column ^C = _Columns->_Columns[Col];
+
+		return _Bridge->ColumnValueToObject(C, _Columns->_Types[Col], v.Err == JET_wrnColumnNull, IntPtr(_Buffer->Data + v.Offset), v.Size);
+	}
+
+	///<summary>Converts all values of one row.</summary>
+	array<Object ^> ^GetRow(int Row)
+	{
+		array<Object ^> ^Values = gcnew array<Object ^>(_Columns->Count);
+
+		for(int c = 0; c < Values->Length; c++)
+			Values[c] = GetValue(Row, c);
+
+		return Values;
+	}
+
+	///<summary>Retrieves a value with GetValue(Row, Col).</summary>
+	property Object ^default[int, int]
+	{
+		Object ^get(int Row, int Col) {return GetValue(Row, Col);}
+	}
+};
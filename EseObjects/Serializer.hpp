@@ -0,0 +1,654 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  EseObjects.Serializer - Pluggable serialization of values without a builtin conversion
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///<summary>Converts objects to and from the bytes stored in a column, for serializable types without a builtin conversion. See Bridge.Serializer.</summary>
+public interface class IValueSerializer
+{
+	///<summary>Writes o, a value of the declared type, to Output. o is never null; null values are stored as a null column instead.</summary>
+	///<remarks>Deserialize is passed the same declared type to read the value back, which may be a base class of or nullable type around the type of o.</remarks>
+	void Serialize(Type ^type, Object ^o, System::IO::Stream ^Output);
+
+	///<summary>Reads a value of the specified type from Input, which holds exactly one serialized value.</summary>
+	Object ^Deserialize(Type ^type, System::IO::Stream ^Input);
+};
+
+///<summary>Serializes with BinaryFormatter, which records full type names in the data. This is the format EseObjects has always used and the default.</summary>
+public ref class BinaryFormatterSerializer : IValueSerializer
+{
+public:
+	virtual void Serialize(Type ^type, Object ^o, System::IO::Stream ^Output)
+	{
+		(gcnew System::Runtime::Serialization::Formatters::Binary::BinaryFormatter())->Serialize(Output, o);
+	}
+
+	virtual Object ^Deserialize(Type ^type, System::IO::Stream ^Input)
+	{
+		return (gcnew System::Runtime::Serialization::Formatters::Binary::BinaryFormatter())->Deserialize(Input);
+	}
+};
+
+//reads and writes values of one type for CompactSerializer
+private ref class CompactCodec abstract
+{
+internal:
+	//nesting beyond this is assumed to be a cycle in the object graph
+	literal int MaxDepth = 64;
+
+	delegate CompactCodec ^Resolver(Type ^type);
+
+	Type ^_Type;
+
+	CompactCodec(Type ^type) :
+		_Type(type)
+	{}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) = 0;
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) = 0;
+
+	static void WriteVarint(System::IO::BinaryWriter ^w, UInt64 v)
+	{
+		while(v >= 0x80)
+		{
+			w->Write(static_cast<Byte>(v | 0x80));
+			v >>= 7;
+		}
+
+		w->Write(static_cast<Byte>(v));
+	}
+
+	static UInt64 ReadVarint(System::IO::BinaryReader ^r)
+	{
+		UInt64 v = 0;
+
+		for(int shift = 0; shift < 64; shift += 7)
+		{
+			Byte b = r->ReadByte();
+
+			v |= static_cast<UInt64>(b & 0x7F) << shift;
+
+			if(!(b & 0x80))
+				return v;
+		}
+
+		throw gcnew System::Runtime::Serialization::SerializationException("Malformed variable length integer");
+	}
+
+	//small magnitudes of either sign stay short
+	static void WriteSigned(System::IO::BinaryWriter ^w, Int64 v)
+	{
+		WriteVarint(w, static_cast<UInt64>((v << 1) ^ (v >> 63)));
+	}
+
+	static Int64 ReadSigned(System::IO::BinaryReader ^r)
+	{
+		UInt64 v = ReadVarint(r);
+
+		return static_cast<Int64>(v >> 1) ^ -static_cast<Int64>(v & 1);
+	}
+
+	//lengths are stored plus one, so zero can mean null
+	static void WriteLength(System::IO::BinaryWriter ^w, Object ^o, int length)
+	{
+		WriteVarint(w, o == nullptr ? 0 : static_cast<UInt64>(length) + 1);
+	}
+
+	//-1 for null
+	static int ReadLength(System::IO::BinaryReader ^r)
+	{
+		UInt64 v = ReadVarint(r);
+
+		if(v > static_cast<UInt64>(Int32::MaxValue) + 1)
+			throw gcnew System::Runtime::Serialization::SerializationException("Length out of range");
+
+		return static_cast<int>(v) - 1;
+	}
+
+	static void CheckDepth(int depth)
+	{
+		if(depth > MaxDepth)
+			throw gcnew System::Runtime::Serialization::SerializationException("Nesting too deep, the object graph may contain a cycle");
+	}
+};
+
+//fixed size values, by TypeCode
+private ref class CompactPrimitiveCodec : CompactCodec
+{
+	TypeCode _Code;
+
+internal:
+	CompactPrimitiveCodec(Type ^type) :
+		CompactCodec(type),
+		_Code(Type::GetTypeCode(type))
+	{}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		switch(_Code)
+		{
+		case TypeCode::Boolean: w->Write(safe_cast<Boolean>(o)); break;
+		case TypeCode::Char: WriteVarint(w, safe_cast<Char>(o)); break;
+		case TypeCode::SByte: w->Write(safe_cast<SByte>(o)); break;
+		case TypeCode::Byte: w->Write(safe_cast<Byte>(o)); break;
+		case TypeCode::Int16: WriteSigned(w, safe_cast<Int16>(o)); break;
+		case TypeCode::UInt16: WriteVarint(w, safe_cast<UInt16>(o)); break;
+		case TypeCode::Int32: WriteSigned(w, safe_cast<Int32>(o)); break;
+		case TypeCode::UInt32: WriteVarint(w, safe_cast<UInt32>(o)); break;
+		case TypeCode::Int64: WriteSigned(w, safe_cast<Int64>(o)); break;
+		case TypeCode::UInt64: WriteVarint(w, safe_cast<UInt64>(o)); break;
+		case TypeCode::Single: w->Write(safe_cast<Single>(o)); break;
+		case TypeCode::Double: w->Write(safe_cast<Double>(o)); break;
+		case TypeCode::Decimal: w->Write(safe_cast<Decimal>(o)); break;
+		case TypeCode::DateTime: w->Write(safe_cast<DateTime>(o).ToBinary()); break;
+		}
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		switch(_Code)
+		{
+		case TypeCode::Boolean: return r->ReadBoolean();
+		case TypeCode::Char: return static_cast<Char>(ReadVarint(r));
+		case TypeCode::SByte: return r->ReadSByte();
+		case TypeCode::Byte: return r->ReadByte();
+		case TypeCode::Int16: return static_cast<Int16>(ReadSigned(r));
+		case TypeCode::UInt16: return static_cast<UInt16>(ReadVarint(r));
+		case TypeCode::Int32: return static_cast<Int32>(ReadSigned(r));
+		case TypeCode::UInt32: return static_cast<UInt32>(ReadVarint(r));
+		case TypeCode::Int64: return ReadSigned(r);
+		case TypeCode::UInt64: return ReadVarint(r);
+		case TypeCode::Single: return r->ReadSingle();
+		case TypeCode::Double: return r->ReadDouble();
+		case TypeCode::Decimal: return r->ReadDecimal();
+		case TypeCode::DateTime: return DateTime::FromBinary(r->ReadInt64());
+		}
+
+		return nullptr;
+	}
+};
+
+//enums as their underlying integer
+private ref class CompactEnumCodec : CompactCodec
+{
+	bool _Signed;
+
+internal:
+	CompactEnumCodec(Type ^type) :
+		CompactCodec(type)
+	{
+		switch(Type::GetTypeCode(Enum::GetUnderlyingType(type)))
+		{
+		case TypeCode::SByte:
+		case TypeCode::Int16:
+		case TypeCode::Int32:
+		case TypeCode::Int64:
+			_Signed = true;
+			break;
+		}
+	}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		if(_Signed)
+			WriteSigned(w, Convert::ToInt64(o));
+		else
+			WriteVarint(w, Convert::ToUInt64(o));
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		if(_Signed)
+			return Enum::ToObject(_Type, ReadSigned(r));
+		else
+			return Enum::ToObject(_Type, ReadVarint(r));
+	}
+};
+
+private ref class CompactTimeSpanCodec : CompactCodec
+{
+internal:
+	CompactTimeSpanCodec() :
+		CompactCodec(TimeSpan::typeid)
+	{}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		WriteSigned(w, safe_cast<TimeSpan>(o).Ticks);
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		return TimeSpan(ReadSigned(r));
+	}
+};
+
+private ref class CompactGuidCodec : CompactCodec
+{
+internal:
+	CompactGuidCodec() :
+		CompactCodec(Guid::typeid)
+	{}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		w->Write(safe_cast<Guid>(o).ToByteArray());
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		array<Byte> ^b = r->ReadBytes(16);
+
+		if(b->Length != 16)
+			throw gcnew System::IO::EndOfStreamException();
+
+		return Guid(b);
+	}
+};
+
+//length prefixed UTF-8
+private ref class CompactStringCodec : CompactCodec
+{
+internal:
+	CompactStringCodec() :
+		CompactCodec(String::typeid)
+	{}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		if(o == nullptr)
+		{
+			WriteLength(w, nullptr, 0);
+			return;
+		}
+
+		array<Byte> ^b = System::Text::Encoding::UTF8->GetBytes(safe_cast<String ^>(o));
+
+		WriteLength(w, o, b->Length);
+		w->Write(b);
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		int len = ReadLength(r);
+
+		if(len < 0)
+			return nullptr;
+
+		array<Byte> ^b = r->ReadBytes(len);
+
+		if(b->Length != len)
+			throw gcnew System::IO::EndOfStreamException();
+
+		return System::Text::Encoding::UTF8->GetString(b);
+	}
+};
+
+//value of the underlying type after a presence flag
+private ref class CompactNullableCodec : CompactCodec
+{
+	CompactCodec ^_Value;
+
+internal:
+	CompactNullableCodec(Type ^type, CompactCodec ^Value) :
+		CompactCodec(type),
+		_Value(Value)
+	{}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		w->Write(o != nullptr);
+
+		if(o != nullptr)
+			_Value->Write(w, o, depth);
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		//a boxed underlying value is also a boxed nullable
+		return r->ReadBoolean() ? _Value->Read(r, depth) : nullptr;
+	}
+};
+
+//one dimensional arrays, with byte arrays copied as a block
+private ref class CompactArrayCodec : CompactCodec
+{
+	Type ^_ElementType;
+	CompactCodec ^_Element; //null for byte arrays
+
+internal:
+	CompactArrayCodec(Type ^type, CompactCodec ^Element) :
+		CompactCodec(type),
+		_ElementType(type->GetElementType()),
+		_Element(Element)
+	{}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		Array ^a = safe_cast<Array ^>(o);
+
+		WriteLength(w, a, a == nullptr ? 0 : a->Length);
+
+		if(a == nullptr)
+			return;
+
+		if(_Element == nullptr)
+		{
+			w->Write(safe_cast<array<Byte> ^>(a));
+			return;
+		}
+
+		CheckDepth(depth);
+
+		for(int i = 0; i < a->Length; i++)
+			_Element->Write(w, a->GetValue(i), depth + 1);
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		int len = ReadLength(r);
+
+		if(len < 0)
+			return nullptr;
+
+		if(_Element == nullptr)
+		{
+			array<Byte> ^b = r->ReadBytes(len);
+
+			if(b->Length != len)
+				throw gcnew System::IO::EndOfStreamException();
+
+			return b;
+		}
+
+		CheckDepth(depth);
+
+		Array ^a = Array::CreateInstance(_ElementType, len);
+
+		for(int i = 0; i < len; i++)
+			a->SetValue(_Element->Read(r, depth + 1), i);
+
+		return a;
+	}
+};
+
+//serializable fields in declaration order, base class fields first
+//classes are preceded by a presence flag; structs are never null
+private ref class CompactObjectCodec : CompactCodec
+{
+internal:
+	delegate Object ^FieldGetter(Object ^o);
+	delegate void FieldSetter(Object ^o, Object ^v);
+
+private:
+	array<FieldGetter ^> ^_Getters;
+	array<FieldSetter ^> ^_Setters;
+	array<CompactCodec ^> ^_Fields;
+
+	static FieldGetter ^MakeGetter(System::Reflection::FieldInfo ^fi)
+	{
+		using namespace System::Reflection::Emit;
+
+		DynamicMethod ^dm = gcnew DynamicMethod("get_" + fi->Name, Object::typeid, gcnew array<Type ^> {Object::typeid}, fi->DeclaringType, true);
+		ILGenerator ^il = dm->GetILGenerator();
+
+		il->Emit(OpCodes::Ldarg_0);
+		il->Emit(fi->DeclaringType->IsValueType ? OpCodes::Unbox : OpCodes::Castclass, fi->DeclaringType);
+		il->Emit(OpCodes::Ldfld, fi);
+		if(fi->FieldType->IsValueType)
+			il->Emit(OpCodes::Box, fi->FieldType);
+		il->Emit(OpCodes::Ret);
+
+		return safe_cast<FieldGetter ^>(dm->CreateDelegate(FieldGetter::typeid));
+	}
+
+	//a struct is modified in place inside its box
+	static FieldSetter ^MakeSetter(System::Reflection::FieldInfo ^fi)
+	{
+		using namespace System::Reflection::Emit;
+
+		DynamicMethod ^dm = gcnew DynamicMethod("set_" + fi->Name, void::typeid, gcnew array<Type ^> {Object::typeid, Object::typeid}, fi->DeclaringType, true);
+		ILGenerator ^il = dm->GetILGenerator();
+
+		il->Emit(OpCodes::Ldarg_0);
+		il->Emit(fi->DeclaringType->IsValueType ? OpCodes::Unbox : OpCodes::Castclass, fi->DeclaringType);
+		il->Emit(OpCodes::Ldarg_1);
+		il->Emit(OpCodes::Unbox_Any, fi->FieldType);
+		il->Emit(OpCodes::Stfld, fi);
+		il->Emit(OpCodes::Ret);
+
+		return safe_cast<FieldSetter ^>(dm->CreateDelegate(FieldSetter::typeid));
+	}
+
+	static int CompareToken(System::Reflection::FieldInfo ^a, System::Reflection::FieldInfo ^b)
+	{
+		return a->MetadataToken.CompareTo(b->MetadataToken);
+	}
+
+internal:
+	CompactObjectCodec(Type ^type) :
+		CompactCodec(type)
+	{}
+
+	//separate from construction so a type containing itself finds this codec in the cache while its fields are resolved
+	void Init(Resolver ^CodecFor)
+	{
+		if(!_Type->IsSerializable)
+			throw gcnew System::Runtime::Serialization::SerializationException("Type " + _Type->FullName + " is not marked as serializable");
+
+		List<System::Reflection::FieldInfo ^> ^fields = gcnew List<System::Reflection::FieldInfo ^>();
+		List<Type ^> ^hierarchy = gcnew List<Type ^>();
+
+		for(Type ^t = _Type; t != nullptr && t != Object::typeid && t != ValueType::typeid; t = t->BaseType)
+			hierarchy->Insert(0, t);
+
+		for each(Type ^t in hierarchy)
+		{
+			array<System::Reflection::FieldInfo ^> ^declared = t->GetFields(System::Reflection::BindingFlags::Instance | System::Reflection::BindingFlags::Public | System::Reflection::BindingFlags::NonPublic | System::Reflection::BindingFlags::DeclaredOnly);
+
+			Array::Sort<System::Reflection::FieldInfo ^>(declared, gcnew Comparison<System::Reflection::FieldInfo ^>(&CompactObjectCodec::CompareToken));
+
+			for each(System::Reflection::FieldInfo ^fi in declared)
+				if(!fi->IsNotSerialized)
+					fields->Add(fi);
+		}
+
+		_Getters = gcnew array<FieldGetter ^>(fields->Count);
+		_Setters = gcnew array<FieldSetter ^>(fields->Count);
+		_Fields = gcnew array<CompactCodec ^>(fields->Count);
+
+		for(int i = 0; i < fields->Count; i++)
+		{
+			_Getters[i] = MakeGetter(fields[i]);
+			_Setters[i] = MakeSetter(fields[i]);
+			_Fields[i] = CodecFor(fields[i]->FieldType);
+		}
+	}
+
+	virtual void Write(System::IO::BinaryWriter ^w, Object ^o, int depth) override
+	{
+		if(!_Type->IsValueType)
+		{
+			w->Write(o != nullptr);
+
+			if(o == nullptr)
+				return;
+		}
+
+		//without type names in the data, only the declared type can be read back
+		if(o->GetType() != _Type)
+			throw gcnew System::Runtime::Serialization::SerializationException("Value of type " + o->GetType()->FullName + " where " + _Type->FullName + " was declared; CompactSerializer requires exact types");
+
+		CheckDepth(depth);
+
+		for(int i = 0; i < _Fields->Length; i++)
+			_Fields[i]->Write(w, _Getters[i](o), depth + 1);
+	}
+
+	virtual Object ^Read(System::IO::BinaryReader ^r, int depth) override
+	{
+		if(!_Type->IsValueType && !r->ReadBoolean())
+			return nullptr;
+
+		CheckDepth(depth);
+
+		Object ^o = System::Runtime::Serialization::FormatterServices::GetUninitializedObject(_Type);
+
+		for(int i = 0; i < _Fields->Length; i++)
+			_Setters[i](o, _Fields[i]->Read(r, depth + 1));
+
+		return o;
+	}
+};
+
+///<summary>
+///Compact binary serialization without type names. Integers are variable length, strings are length prefixed UTF-8, and objects are their serializable fields in declaration order.
+///The reader and writer for each type are built once, with field access compiled to IL, and shared by all instances.
+///</summary>
+///<remarks>
+///Supports primitives, enums, Decimal, DateTime, TimeSpan, Guid, String, nullable types, one dimensional arrays and [Serializable] classes and structs made of those.
+///<pr/>Values are written and read as their declared type, so fields and the value itself must hold exactly that type. Values declared as Object, an interface or a base class of the actual value are rejected.
+///<pr/>Constructors, ISerializable and serialization callbacks are not used. Object graphs must be trees: shared references are written once per reference and cycles are rejected.
+///<pr/>Adding, removing or reordering fields changes the format, so existing data must be rewritten when a stored type changes.
+///<pr/>Deserialize throws SerializationException when the input has bytes left over, which usually means it was written as a different type.
+///</remarks>
+public ref class CompactSerializer sealed : IValueSerializer
+{
+	static Dictionary<Type ^, CompactCodec ^> ^_Codecs = gcnew Dictionary<Type ^, CompactCodec ^>();
+
+	//types cached by the build in progress, in order; if it fails, codecs built for nested types may refer to the failed codec, so all of them are dropped
+	static List<Type ^> ^_Building = gcnew List<Type ^>();
+	static int _BuildDepth;
+
+	static void Cache(Type ^type, CompactCodec ^c)
+	{
+		_Codecs[type] = c;
+		_Building->Add(type);
+	}
+
+	static CompactCodec ^Build(Type ^type)
+	{
+		if(type == String::typeid)
+			return gcnew CompactStringCodec();
+		if(type == Guid::typeid)
+			return gcnew CompactGuidCodec();
+		if(type == TimeSpan::typeid)
+			return gcnew CompactTimeSpanCodec();
+		if(type->IsEnum)
+			return gcnew CompactEnumCodec(type);
+		if(type->IsPrimitive || type == Decimal::typeid || type == DateTime::typeid)
+		{
+			if(type == IntPtr::typeid || type == UIntPtr::typeid)
+				throw gcnew NotSupportedException("CompactSerializer can't store pointers");
+
+			return gcnew CompactPrimitiveCodec(type);
+		}
+		if(type->IsArray)
+		{
+			if(type->GetArrayRank() != 1)
+				throw gcnew NotSupportedException("CompactSerializer only supports one dimensional arrays");
+
+			Type ^elem = type->GetElementType();
+
+			return gcnew CompactArrayCodec(type, elem == Byte::typeid ? nullptr : CodecFor(elem));
+		}
+		if(Nullable::GetUnderlyingType(type) != nullptr)
+			return gcnew CompactNullableCodec(type, CodecFor(Nullable::GetUnderlyingType(type)));
+		if(type == Object::typeid || type->IsInterface || type->IsAbstract || type->IsPointer)
+			throw gcnew NotSupportedException("CompactSerializer can't store " + type->FullName + " without type names");
+
+		CompactObjectCodec ^c = gcnew CompactObjectCodec(type);
+
+		Cache(type, c);
+		c->Init(gcnew CompactCodec::Resolver(&CompactSerializer::CodecFor));
+
+		return c;
+	}
+
+internal:
+	static CompactCodec ^CodecFor(Type ^type)
+	{
+		System::Threading::Monitor::Enter(_Codecs);
+		try
+		{
+			CompactCodec ^c;
+
+			if(_Codecs->TryGetValue(type, c))
+				return c;
+
+			_BuildDepth++;
+			try
+			{
+				c = Build(type);
+				Cache(type, c);
+			}
+			catch(Exception ^)
+			{
+				if(_BuildDepth == 1)
+				{
+					for each(Type ^t in _Building)
+						_Codecs->Remove(t);
+				}
+
+				throw;
+			}
+			finally
+			{
+				if(--_BuildDepth == 0)
+					_Building->Clear();
+			}
+
+			return c;
+		}
+		finally
+		{
+			System::Threading::Monitor::Exit(_Codecs);
+		}
+	}
+
+public:
+	virtual void Serialize(Type ^type, Object ^o, System::IO::Stream ^Output)
+	{
+		System::IO::BinaryWriter ^w = gcnew System::IO::BinaryWriter(Output, System::Text::Encoding::UTF8);
+
+		CodecFor(type)->Write(w, o, 0);
+		w->Flush(); //not closed, the caller owns the stream
+	}
+
+	virtual Object ^Deserialize(Type ^type, System::IO::Stream ^Input)
+	{
+		Object ^o = CodecFor(type)->Read(gcnew System::IO::BinaryReader(Input, System::Text::Encoding::UTF8), 0);
+
+		//no type names are stored, so bytes left over are the only sign the value was written as a different type
+		if(Input->CanSeek ? Input->Position < Input->Length : Input->ReadByte() != -1)
+			throw gcnew System::Runtime::Serialization::SerializationException("Input has bytes left over after reading " + type->FullName + "; the value may have been written as a different type");
+
+		return o;
+	}
+};
@@ -43,6 +43,8 @@ internal:
 	JET_SESID _JetSesid;
 	Transaction ^_CurrentTrans;
 	Bridge ^_Bridge;
+	//incremented on each rollback, since a rollback can undo DDL and make cached table schemas stale
+	ulong _SchemaGeneration;
 
 private:
 	static JET_SESID BeginSession(JET_INSTANCE JetInstance)
@@ -159,12 +161,14 @@ internal:
 	///<summary>Cancels a transaction without using a EseObjects.Transaction. Calls JetRollback.</summary>
 	void RollbackTransaction()
 	{
+		_SchemaGeneration++;
 		EseException::RaiseOnError(JetRollback(_JetSesid, 0));
 	}
 
 	///<summary>Cancels all current transactions without using EseObjects.Transaction objects. Calls JetRollback with JET_bitRollbackAll.</summary>
 	void RollbackAllTransactions()
 	{
+		_SchemaGeneration++;
 		EseException::RaiseOnError(JetRollback(_JetSesid, JET_bitRollbackAll));
 	}
 
@@ -42,6 +42,7 @@
 
 #include <esent.h>
 #include <malloc.h>
+#include <emmintrin.h>
 
 #include "JetHeaderSupplement.h"
 
@@ -59,6 +60,7 @@ typedef unsigned char uchar;
 
 //CLR support
 #include <msclr\marshal.h>
+#include <vcclr.h>
 using namespace System;
 using namespace msclr::interop;
 using namespace System::Collections::Generic;
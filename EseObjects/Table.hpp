@@ -256,7 +256,7 @@ private:
 	static Table ^InternalCreate(Database ^Db, CreateOptions Parameters, [Out] array<Column ^> ^*CreatedColumns, [Out] array<Index ^> ^*CreatedIndexes)
 	{
 		marshal_context mc;
-		free_list fl;
+		region fl;
 
 		JET_TABLECREATE jtc = {sizeof jtc};
 		JET_INDEXCREATE_SHORT **jic_ptrs;
@@ -382,6 +382,9 @@ private:
 			throw OverallError;
 		}
 
+		//any schema cached for a previous table of the same name is stale
+		TableSchema::Forget(Db, Parameters.Name);
+
 		//create return objects
 
 		EseObjects::TableID ^NTableID = gcnew EseObjects::TableID(jtc.tableid, Db->Session->CurrentTransaction, Db);
@@ -407,6 +410,8 @@ private:
 
 				i++;
 			}
+
+			TableSchema::ForTableID(NTableID)->Share(*CreatedColumns);
 		}
 
 		if(CreatedIndexes)
@@ -428,7 +433,7 @@ private:
 	static Cursor ^InternalCreateTemp(Session ^Session, CreateTempOptions Parameters, [Out] array<Column ^> ^*CreatedColumns)
 	{
 		marshal_context mc;
-		free_list fl;
+		region fl;
 
 		if(!Parameters.Columns || Parameters.Columns->Count < 1)
 			throw gcnew ArgumentException("Must specify at least one column when creating a temp table");
@@ -509,6 +514,8 @@ private:
 			EseException::RaiseOnError(status);
 		}
 
+		EseObjects::TableID ^NTableID = gcnew EseObjects::TableID(jtid, Session->CurrentTransaction, gcnew EseObjects::Database(Session));
+
 		if(CreatedColumns)
 		{
 			*CreatedColumns = gcnew array<Column ^>(col_ct);
@@ -521,9 +528,9 @@ private:
 				(*CreatedColumns)[i] = gcnew Column(jcds[i], nullptr, nullptr, nullptr);
 				i++;
 			}
-		}
 
-		EseObjects::TableID ^NTableID = gcnew EseObjects::TableID(jtid, Session->CurrentTransaction, gcnew EseObjects::Database(Session));
+			TableSchema::ForTableID(NTableID)->Share(*CreatedColumns);
+		}
 
 		Cursor ^NCursor = gcnew Cursor(NTableID);
 
@@ -584,6 +591,8 @@ public:
 		char const *namestr = mc.marshal_as<char const *>(Name);
 
 		EseException::RaiseOnError(JetDeleteTable(Db->Session->_JetSesid, Db->_JetDbid, namestr));
+
+		TableSchema::Forget(Db, Name);
 	}
 
 	///<summary>Session associated with this table handle</summary>
@@ -650,6 +659,8 @@ public:
 			EseException::RaiseOnError(JetGetTableInfo(Session->_JetSesid, _TableID->_JetTableID, oldname, JET_cbNameMost+1, JET_TblInfoName));
 
 			EseException::RaiseOnError(JetRenameTable(Session->_JetSesid, Database->_JetDbid, oldname, newname));
+
+			TableSchema::Rename(Database, marshal_as<String ^>(oldname), NewName);
 		}
 	}
 
@@ -769,7 +780,10 @@ public:
 	{
 		IList<Column ^> ^get()
 		{
-			return QueryTableColumns(Session->_JetSesid, _TableID->_JetTableID)->Values;
+			IList<Column ^> ^Cols = QueryTableColumns(Session->_JetSesid, _TableID->_JetTableID)->Values;
+
+			TableSchema::ForTableID(_TableID)->Share(Cols);
+			return Cols;
 		}
 	}
 
@@ -33,6 +33,7 @@ private ref class TableID
 {
 internal:
 	JET_TABLEID _JetTableID;
+	TableSchema ^_Schema; //resolved on first use by TableSchema::ForTableID
 
 private:
 	Transaction ^_Trans;
@@ -102,7 +103,9 @@ internal:
 
 		EseException::RaiseOnError(JetDupCursor(_Db->Session->_JetSesid, _JetTableID, &newtab, 0));
 
-		return gcnew TableID(newtab, _Trans, _Db);
+		TableID ^dup = gcnew TableID(newtab, _Trans, _Db);
+		dup->_Schema = _Schema;
+		return dup;
 	}
 
 	property EseObjects::Session ^Session
@@ -0,0 +1,208 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  EseObjects.TableSchema - Cached column definitions per table
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///<summary>
+///Column definitions for one table, cached so name based access doesn't need a JetGetTableColumnInfo call each time.
+///Shared by all TableIDs opened on the same table through the same Database object.
+///</summary>
+///<remarks>
+///Column.Create, Column.Delete, Column.RenameColumn and Table create, delete and rename invalidate the cache, as does any rollback on the session.
+///Schema changes made through another session or outside of EseObjects are not detected.
+///<pr/>Also holds the Column.CompressionThreshold of each column, which is a setting rather than cached schema, so it is kept through invalidation.
+///</remarks>
+private ref class TableSchema
+{
+	initonly Session ^_Session;
+	ulong _Generation;
+	initonly Dictionary<String ^, Column ^> ^_ColumnsByName;
+	SortedList<JET_COLUMNID, Column ^> ^_ColumnsByID; //all columns, never modified once built; replaced on invalidation
+
+	TableSchema(Session ^Session) :
+		_Session(Session),
+		_Generation(Session->_SchemaGeneration),
+		_ColumnsByName(gcnew Dictionary<String ^, Column ^>(StringComparer::OrdinalIgnoreCase)),
+		_Thresholds(gcnew Dictionary<JET_COLUMNID, ulong>())
+	{}
+
+	//drops everything if there has been a rollback since the cache was filled
+	void CheckGeneration()
+	{
+		if(_Generation != _Session->_SchemaGeneration)
+		{
+			Invalidate();
+			_Generation = _Session->_SchemaGeneration;
+		}
+	}
+
+internal:
+	//compression thresholds by column id, shared by every Column object opened on the table, see Column.CompressionThreshold
+	initonly Dictionary<JET_COLUMNID, ulong> ^_Thresholds;
+
+	///<summary>Makes the columns use this table's compression thresholds.</summary>
+	void Share(IEnumerable<Column ^> ^Cols)
+	{
+		for each(Column ^Col in Cols)
+			Col->_Thresholds = _Thresholds;
+	}
+
+	void Invalidate()
+	{
+		_ColumnsByName->Clear();
+		_ColumnsByID = nullptr;
+	}
+
+	///<summary>Finds a column by name, calling JetGetTableColumnInfo only the first time a name is seen.</summary>
+	Column ^LookupColumn(JET_SESID sesid, JET_TABLEID tableid, String ^Name)
+	{
+		CheckGeneration();
+
+		Column ^Col;
+
+		if(_ColumnsByName->TryGetValue(Name, Col))
+			return Col;
+
+		Col = gcnew Column(sesid, tableid, Name);
+		Col->_Thresholds = _Thresholds;
+		_ColumnsByName[Name] = Col;
+
+		return Col;
+	}
+
+	///<summary>Map of all columns in the table by JET_COLUMNID, built with QueryTableColumns the first time it's needed.</summary>
+	///<remarks>The returned map is not modified afterward, so it may be held across schema changes; it just won't reflect them.</remarks>
+	SortedList<JET_COLUMNID, Column ^> ^GetColumnsByID(JET_SESID sesid, JET_TABLEID tableid)
+	{
+		CheckGeneration();
+
+		if(_ColumnsByID == nullptr)
+		{
+			_ColumnsByID = QueryTableColumns(sesid, tableid);
+			Share(_ColumnsByID->Values);
+		}
+
+		return _ColumnsByID;
+	}
+
+	static String ^TableName(TableID ^Tabid)
+	{
+		char buff[JET_cbNameMost+1];
+
+		EseException::RaiseOnError(JetGetTableInfo(Tabid->Session->_JetSesid, Tabid->_JetTableID, buff, JET_cbNameMost+1, JET_TblInfoName));
+
+		return marshal_as<String ^>(buff);
+	}
+
+	///<summary>Retrieves the schema shared by all tables with the same name in the TableID's Database, creating it if needed.</summary>
+	static TableSchema ^ForTableID(TableID ^Tabid)
+	{
+		if(Tabid->_Schema != nullptr)
+			return Tabid->_Schema;
+
+		Database ^Db = Tabid->Database;
+		TableSchema ^Schema;
+
+		if(!Db->_JetDbid)
+			Schema = gcnew TableSchema(Db->Session); //temp tables have no name to share by
+		else
+		{
+			String ^Name = TableName(Tabid);
+
+			if(Db->_Schemas == nullptr)
+				Db->_Schemas = gcnew Dictionary<String ^, TableSchema ^>(StringComparer::OrdinalIgnoreCase);
+
+			if(!Db->_Schemas->TryGetValue(Name, Schema))
+			{
+				Schema = gcnew TableSchema(Db->Session);
+				Db->_Schemas->Add(Name, Schema);
+			}
+		}
+
+		Tabid->_Schema = Schema;
+
+		return Schema;
+	}
+
+	///<summary>Invalidates and drops any schema cached for a table name, for when a table is created, deleted or renamed.</summary>
+	static void Forget(Database ^Db, String ^TableName)
+	{
+		TableSchema ^Schema;
+
+		if(Db->_Schemas != nullptr && Db->_Schemas->TryGetValue(TableName, Schema))
+		{
+			Schema->Invalidate();
+			Db->_Schemas->Remove(TableName);
+		}
+	}
+
+	///<summary>Moves the schema cached for a table to its new name, so TableIDs opened before and after the rename keep sharing it.</summary>
+	static void Rename(Database ^Db, String ^OldName, String ^NewName)
+	{
+		if(Db->_Schemas == nullptr)
+			return;
+
+		TableSchema ^Schema;
+		bool Found = Db->_Schemas->TryGetValue(OldName, Schema);
+
+		if(Found)
+			Db->_Schemas->Remove(OldName);
+
+		Forget(Db, NewName); //schema of a previously deleted table with the new name
+
+		if(Found)
+		{
+			Schema->Invalidate();
+			Db->_Schemas->Add(NewName, Schema);
+		}
+	}
+
+	///<summary>Invalidates any schema cached for the TableID's table without creating one.</summary>
+	static void Invalidate(TableID ^Tabid)
+	{
+		if(Tabid->_Schema != nullptr)
+			Tabid->_Schema->Invalidate();
+
+		Database ^Db = Tabid->Database;
+		TableSchema ^Schema;
+
+		if(Db->_JetDbid && Db->_Schemas != nullptr && Db->_Schemas->TryGetValue(TableName(Tabid), Schema))
+			Schema->Invalidate();
+	}
+};
+
+void InvalidateTableSchema(Table ^Tab)
+{
+	TableSchema::Invalidate(GetTableIDObj(Tab));
+}
+
+Dictionary<JET_COLUMNID, ulong> ^GetTableThresholds(TableID ^Tabid)
+{
+	return TableSchema::ForTableID(Tabid)->_Thresholds;
+}
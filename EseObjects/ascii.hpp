@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  ascii - SSE2 transcoding between ASCII and UTF-16
+///////////////////////////////////////////////////////////////////////////////
+// 
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//transcoding for cp 1252 text columns without going through System::Text::Encoding or WideCharToMultiByte
+//both directions handle 16 characters per step with SSE2 and only accept pure ASCII
+//on finding anything else they return false so the caller can fall back to the general conversion
+#pragma managed(push, off)
+
+//true if no character is outside ASCII, so ascii_narrow will succeed; lets a caller check before allocating dest
+inline bool ascii_only(wchar_t const *src, size_t ct)
+{
+	__m128i const nonascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+	__m128i any = _mm_setzero_si128();
+	size_t i = 0;
+
+	for(; i + 8 <= ct; i += 8)
+		any = _mm_or_si128(any, _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + i)));
+
+	if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(any, nonascii), _mm_setzero_si128())) != 0xFFFF)
+		return false;
+
+	for(; i < ct; i++)
+		if(src[i] > 0x7F)
+			return false;
+
+	return true;
+}
+
+//narrows UTF-16 to one byte per character; false if any character is outside ASCII, in which case dest is partially written
+inline bool ascii_narrow(wchar_t const *src, char *dest, size_t ct)
+{
+	__m128i const nonascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+	__m128i const zero = _mm_setzero_si128();
+	size_t i = 0;
+
+	for(; i + 16 <= ct; i += 16)
+	{
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + i));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + i + 8));
+
+		if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(lo, hi), nonascii), zero)) != 0xFFFF)
+			return false;
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), _mm_packus_epi16(lo, hi));
+	}
+
+	for(; i < ct; i++)
+	{
+		if(src[i] > 0x7F)
+			return false;
+
+		dest[i] = static_cast<char>(src[i]);
+	}
+
+	return true;
+}
+
+//widens one byte characters to UTF-16; false if any byte is outside ASCII, in which case dest is partially written
+inline bool ascii_widen(char const *src, wchar_t *dest, size_t ct)
+{
+	__m128i const zero = _mm_setzero_si128();
+	size_t i = 0;
+
+	for(; i + 16 <= ct; i += 16)
+	{
+		__m128i x = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + i));
+
+		if(_mm_movemask_epi8(x)) //high bit of any byte set
+			return false;
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), _mm_unpacklo_epi8(x, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i + 8), _mm_unpackhi_epi8(x, zero));
+	}
+
+	for(; i < ct; i++)
+	{
+		if(static_cast<uchar>(src[i]) > 0x7F)
+			return false;
+
+		dest[i] = static_cast<uchar>(src[i]);
+	}
+
+	return true;
+}
+
+#pragma managed(pop)
@@ -0,0 +1,320 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  lz - LZ77 compression and framing of long values
+///////////////////////////////////////////////////////////////////////////////
+// 
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//block compression for long values, in the spirit of LZ4: each sequence is a token byte, literals, a 16 bit offset and a match length
+//the high nibble of the token is the literal count and the low nibble the match length less LZ_MIN_MATCH; 15 in either continues with bytes added until one is below 255
+//the last sequence has literals only, so the input ends right after them
+//matches are found through a single hash table of recent positions, favoring speed over ratio
+#pragma managed(push, off)
+
+size_t const LZ_MIN_MATCH = 4;
+size_t const LZ_MAX_OFFSET = 0xFFFF;
+int const LZ_HASH_BITS = 12;
+
+inline unsigned lz_read32(uchar const *p)
+{
+	unsigned v;
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+inline unsigned lz_hash(unsigned v)
+{
+	return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+//length beyond what fits in a nibble; null if dest is full
+inline uchar *lz_put_length(uchar *op, uchar *oend, size_t len)
+{
+	for(; len >= 255; len -= 255)
+	{
+		if(op == oend)
+			return null;
+		*op++ = 255;
+	}
+
+	if(op == oend)
+		return null;
+	*op++ = static_cast<uchar>(len);
+
+	return op;
+}
+
+inline bool lz_get_length(uchar const *&ip, uchar const *iend, size_t &len)
+{
+	uchar b;
+
+	do
+	{
+		if(ip == iend)
+			return false;
+		b = *ip++;
+		len += b;
+	} while(b == 255);
+
+	return true;
+}
+
+//one sequence; match_len is ignored when last is set, since the final sequence has no match
+inline uchar *lz_put_sequence(uchar *op, uchar *oend, uchar const *lit, size_t lit_len, size_t offset, size_t match_len, bool last)
+{
+	if(op == oend)
+		return null;
+
+	uchar *token = op++;
+
+	*token = static_cast<uchar>((lit_len < 15 ? lit_len : 15) << 4);
+
+	if(lit_len >= 15 && !(op = lz_put_length(op, oend, lit_len - 15)))
+		return null;
+
+	if(static_cast<size_t>(oend - op) < lit_len)
+		return null;
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	if(last)
+		return op;
+
+	if(oend - op < 2)
+		return null;
+	*op++ = static_cast<uchar>(offset);
+	*op++ = static_cast<uchar>(offset >> 8);
+
+	*token |= static_cast<uchar>(match_len < 15 ? match_len : 15);
+
+	if(match_len >= 15 && !(op = lz_put_length(op, oend, match_len - 15)))
+		return null;
+
+	return op;
+}
+
+//compresses ct bytes of src into at most cap bytes of dest
+//returns the compressed size, or 0 if it doesn't fit in cap; passing a cap below ct gives up as soon as compression stops paying off
+inline size_t lz_compress(uchar const *src, size_t ct, uchar *dest, size_t cap)
+{
+	unsigned table[1 << LZ_HASH_BITS];
+	uchar const *ip = src;
+	uchar const *anchor = src;
+	uchar const *const iend = src + ct;
+	uchar *op = dest;
+	uchar *const oend = dest + cap;
+
+	memset(table, 0, sizeof table);
+
+	while(iend - ip >= static_cast<ptrdiff_t>(LZ_MIN_MATCH))
+	{
+		unsigned seq = lz_read32(ip);
+		unsigned h = lz_hash(seq);
+		uchar const *ref = src + table[h];
+
+		table[h] = static_cast<unsigned>(ip - src);
+
+		if(ref >= ip || static_cast<size_t>(ip - ref) > LZ_MAX_OFFSET || lz_read32(ref) != seq)
+		{
+			ip++;
+			continue;
+		}
+
+		uchar const *mp = ip + LZ_MIN_MATCH;
+		uchar const *rp = ref + LZ_MIN_MATCH;
+
+		while(mp < iend && *mp == *rp)
+		{
+			mp++;
+			rp++;
+		}
+
+		op = lz_put_sequence(op, oend, anchor, ip - anchor, ip - ref, mp - ip - LZ_MIN_MATCH, false);
+		if(!op)
+			return 0;
+
+		ip = anchor = mp;
+	}
+
+	op = lz_put_sequence(op, oend, anchor, iend - anchor, 0, 0, true);
+	if(!op)
+		return 0;
+
+	return op - dest;
+}
+
+//expands ct bytes of src into exactly out_ct bytes of dest; false if src is malformed or doesn't expand to out_ct bytes
+inline bool lz_decompress(uchar const *src, size_t ct, uchar *dest, size_t out_ct)
+{
+	uchar const *ip = src;
+	uchar const *const iend = src + ct;
+	uchar *op = dest;
+	uchar *const oend = dest + out_ct;
+
+	for(;;)
+	{
+		if(ip == iend)
+			return false;
+
+		unsigned token = *ip++;
+		size_t lit_len = token >> 4;
+
+		if(lit_len == 15 && !lz_get_length(ip, iend, lit_len))
+			return false;
+		if(static_cast<size_t>(iend - ip) < lit_len || static_cast<size_t>(oend - op) < lit_len)
+			return false;
+
+		memcpy(op, ip, lit_len);
+		ip += lit_len;
+		op += lit_len;
+
+		if(ip == iend)
+			return op == oend;
+
+		if(iend - ip < 2)
+			return false;
+
+		size_t offset = ip[0] | (ip[1] << 8);
+		size_t match_len = token & 15;
+
+		ip += 2;
+
+		if(offset == 0 || offset > static_cast<size_t>(op - dest))
+			return false;
+		if(match_len == 15 && !lz_get_length(ip, iend, match_len))
+			return false;
+
+		match_len += LZ_MIN_MATCH;
+
+		if(static_cast<size_t>(oend - op) < match_len)
+			return false;
+
+		uchar const *ref = op - offset;
+
+		if(offset >= match_len)
+			memcpy(op, ref, match_len);
+		else
+			for(size_t i = 0; i < match_len; i++) //overlapping match repeats the last offset bytes
+				op[i] = ref[i];
+
+		op += match_len;
+	}
+}
+
+//framing of long values as stored in the database
+//only columns with compression enabled are framed; there every value is written framed if it starts with LZ_MAGIC, so values without it are read as is
+//a framed value starts with LZ_MAGIC and a codec byte
+//LZ_CODEC_STORED is an uncompressed value that happened to start with the magic
+//LZ_CODEC_LZ1 is followed by the expanded size as 4 bytes little endian, then lz_compress output
+uchar const LZ_MAGIC[3] = {0xE5, 'L', 'Z'};
+uchar const LZ_CODEC_STORED = 0;
+uchar const LZ_CODEC_LZ1 = 1;
+size_t const LZ_STORED_HEADER = 4;
+size_t const LZ_LZ1_HEADER = 8;
+//each input byte of lz_compress output expands to at most this many bytes, since a run length byte of 255 is the densest encoding
+size_t const LZ_MAX_RATIO = 255;
+//largest expanded size accepted from a header, the largest array .NET can hold
+size_t const LZ_MAX_EXPANDED = 0x7FFFFFFF;
+
+inline bool lz_framed(void const *src, size_t ct)
+{
+	uchar const *p = static_cast<uchar const *>(src);
+
+	return ct >= LZ_STORED_HEADER && p[0] == LZ_MAGIC[0] && p[1] == LZ_MAGIC[1] && p[2] == LZ_MAGIC[2] && p[3] <= LZ_CODEC_LZ1;
+}
+
+//size of the value a framed value expands to; false if the header is incomplete or the size it gives can't come from ct bytes
+inline bool lz_frame_length(void const *src, size_t ct, size_t &out_ct)
+{
+	uchar const *p = static_cast<uchar const *>(src);
+
+	if(ct < LZ_STORED_HEADER)
+		return false;
+
+	if(p[3] == LZ_CODEC_STORED)
+	{
+		out_ct = ct - LZ_STORED_HEADER;
+		return true;
+	}
+
+	if(ct < LZ_LZ1_HEADER)
+		return false;
+
+	out_ct = p[4] | (p[5] << 8) | (p[6] << 16) | (static_cast<size_t>(p[7]) << 24);
+
+	return out_ct <= LZ_MAX_EXPANDED && out_ct <= (ct - LZ_LZ1_HEADER + 1) * LZ_MAX_RATIO;
+}
+
+//expands a framed value into dest, which must hold the size given by lz_frame_length
+inline bool lz_unframe(void const *src, size_t ct, void *dest, size_t out_ct)
+{
+	uchar const *p = static_cast<uchar const *>(src);
+
+	if(p[3] == LZ_CODEC_STORED)
+	{
+		memcpy(dest, p + LZ_STORED_HEADER, out_ct);
+		return true;
+	}
+
+	return lz_decompress(p + LZ_LZ1_HEADER, ct - LZ_LZ1_HEADER, static_cast<uchar *>(dest), out_ct);
+}
+
+//compresses ct bytes of src into a framed value in dest, which must have room for ct - 1 bytes
+//returns the framed size, or 0 if compression doesn't make the value smaller
+inline size_t lz_frame(void const *src, size_t ct, void *dest)
+{
+	uchar *d = static_cast<uchar *>(dest);
+
+	if(ct <= LZ_LZ1_HEADER + 1)
+		return 0;
+
+	size_t sz = lz_compress(static_cast<uchar const *>(src), ct, d + LZ_LZ1_HEADER, ct - 1 - LZ_LZ1_HEADER);
+
+	if(!sz)
+		return 0;
+
+	memcpy(d, LZ_MAGIC, sizeof LZ_MAGIC);
+	d[3] = LZ_CODEC_LZ1;
+	d[4] = static_cast<uchar>(ct);
+	d[5] = static_cast<uchar>(ct >> 8);
+	d[6] = static_cast<uchar>(ct >> 16);
+	d[7] = static_cast<uchar>(ct >> 24);
+
+	return LZ_LZ1_HEADER + sz;
+}
+
+//frames ct bytes of src uncompressed into dest, which must have room for LZ_STORED_HEADER + ct bytes
+inline void lz_frame_stored(void const *src, size_t ct, void *dest)
+{
+	uchar *d = static_cast<uchar *>(dest);
+
+	memcpy(d, LZ_MAGIC, sizeof LZ_MAGIC);
+	d[3] = LZ_CODEC_STORED;
+	memcpy(d + LZ_STORED_HEADER, src, ct);
+}
+
+#pragma managed(pop)
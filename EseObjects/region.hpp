@@ -0,0 +1,286 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  region - Bump allocator for temporary native memory, freed all at once
+///////////////////////////////////////////////////////////////////////////////
+// 
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//counts of heap activity by regions, read through NativeAllocations to measure what an operation costs
+//only the slow paths touch these, so they are always kept
+struct region_counters
+{
+	static LONG volatile HeapBlocks; //_aligned_malloc calls, for new chunks and large blocks
+	static LONG volatile LargeBlocks; //allocations too large for a chunk
+	static LONG volatile ChunksTaken; //chunks handed out by the pool, whether reused or new
+};
+
+LONG volatile region_counters::HeapBlocks = 0;
+LONG volatile region_counters::LargeBlocks = 0;
+LONG volatile region_counters::ChunksTaken = 0;
+
+//block of memory allocations are carved from; recycled through region_chunk_pool
+//the header is padded to MEMORY_ALLOCATION_ALIGNMENT as required for SLIST_ENTRY
+struct DECLSPEC_ALIGN(MEMORY_ALLOCATION_ALIGNMENT) region_chunk
+{
+	SLIST_ENTRY Entry; //must be first, for the pool
+	region_chunk *Next; //chunks of one region
+	size_t Size; //usable bytes after the header
+
+	char *data() {return reinterpret_cast<char *>(this + 1);}
+};
+
+//pool of standard size chunks shared by all regions
+//a lock free list is used so threads driving sessions concurrently don't contend on a lock or on the heap
+class region_chunk_pool
+{
+	static SLIST_HEADER Free;
+	static LONG volatile Initialized;
+
+	//0 not initialized, 1 being initialized by another thread, 2 ready
+	static void init()
+	{
+		if(Initialized == 2)
+			return;
+
+		if(InterlockedCompareExchange(&Initialized, 1, 0) == 0)
+		{
+			InitializeSListHead(&Free);
+			InterlockedExchange(&Initialized, 2);
+		}
+		else
+			while(Initialized != 2)
+				SwitchToThread();
+	}
+
+public:
+	//usable size of a standard chunk
+	static size_t const ChunkSize = 0x1000 - sizeof(region_chunk);
+	//most chunks kept for reuse, anything beyond is freed
+	static USHORT const MaxPooled = 64;
+
+	static region_chunk *get()
+	{
+		init();
+
+		region_chunk *c = reinterpret_cast<region_chunk *>(InterlockedPopEntrySList(&Free));
+
+		InterlockedIncrement(&region_counters::ChunksTaken);
+
+		if(!c)
+		{
+			c = static_cast<region_chunk *>(_aligned_malloc(sizeof(region_chunk) + ChunkSize, MEMORY_ALLOCATION_ALIGNMENT));
+
+			if(!c)
+				throw std::bad_alloc();
+
+			InterlockedIncrement(&region_counters::HeapBlocks);
+
+			c->Size = ChunkSize;
+		}
+
+		c->Next = null;
+		return c;
+	}
+
+	static void put(region_chunk *c)
+	{
+		if(QueryDepthSList(&Free) < MaxPooled)
+			InterlockedPushEntrySList(&Free, &c->Entry);
+		else
+			_aligned_free(c);
+	}
+};
+
+SLIST_HEADER region_chunk_pool::Free;
+LONG volatile region_chunk_pool::Initialized = 0;
+
+//temporary native memory for the duration of one operation, such as converting values for JetSetColumn or building a JET_TABLECREATE
+//allocations are carved sequentially from inline storage, then from pooled chunks; nothing is freed individually
+//everything is released at once by reset or destruction, returning chunks to the pool
+//only for types that need no destructor; memory from alloc_array isn't initialized
+class region
+{
+	//allocation larger than this gets its own block instead of a pooled chunk
+	static size_t const LargeSize = region_chunk_pool::ChunkSize / 2;
+	static size_t const InlineSize = 128;
+
+	//small allocations, like the value of a scalar being converted for JetSetColumn or JetMakeKey, come from here before any chunk is taken
+	union
+	{
+		char Inline[InlineSize];
+		__int64 InlineAlign;
+		double InlineAlignD;
+	};
+
+	char *Pos; //next free byte in the current block
+	char *End; //end of the current block
+	region_chunk *Chunks; //standard chunks in use, most recent first
+	region_chunk *Large; //individually allocated blocks
+
+	//managed objects pinned by pin, kept in the region's own memory
+	struct pinned
+	{
+		pinned *Next;
+		void *Handle; //GCHandle as IntPtr
+	};
+
+	pinned *Pins;
+
+	//not copyable, pointers into Inline would refer to the original
+	region(region const &);
+	region &operator=(region const &);
+
+	static size_t align(size_t ct)
+	{
+		return (ct + 7) & ~size_t(7);
+	}
+
+	void *alloc_large(size_t ct)
+	{
+		region_chunk *c = static_cast<region_chunk *>(_aligned_malloc(sizeof(region_chunk) + ct, MEMORY_ALLOCATION_ALIGNMENT));
+
+		if(!c)
+			throw std::bad_alloc();
+
+		InterlockedIncrement(&region_counters::HeapBlocks);
+		InterlockedIncrement(&region_counters::LargeBlocks);
+
+		c->Size = ct;
+		c->Next = Large;
+		Large = c;
+
+		return c->data();
+	}
+
+public:
+	region() :
+		Pos(Inline),
+		End(Inline + InlineSize),
+		Chunks(null),
+		Large(null),
+		Pins(null)
+	{}
+
+	~region()
+	{
+		reset();
+	}
+
+	//releases all allocations, keeping nothing; the region can be reused afterward
+	void reset()
+	{
+		//entries live in the chunks, so unpin before returning them
+		while(Pins)
+		{
+			System::Runtime::InteropServices::GCHandle::FromIntPtr(System::IntPtr(Pins->Handle)).Free();
+			Pins = Pins->Next;
+		}
+
+		while(Chunks)
+		{
+			region_chunk *c = Chunks;
+			Chunks = c->Next;
+			region_chunk_pool::put(c);
+		}
+
+		while(Large)
+		{
+			region_chunk *c = Large;
+			Large = c->Next;
+			_aligned_free(c);
+		}
+
+		Pos = Inline;
+		End = Inline + InlineSize;
+	}
+
+	//uninitialized block of ct bytes, 8 byte aligned
+	void *alloc_bytes(size_t ct)
+	{
+		size_t aligned = align(ct);
+
+		if(aligned > static_cast<size_t>(End - Pos))
+		{
+			if(aligned > LargeSize)
+				return alloc_large(ct);
+
+			region_chunk *c = region_chunk_pool::get();
+
+			c->Next = Chunks;
+			Chunks = c;
+			Pos = c->data();
+			End = Pos + c->Size;
+		}
+
+		void *x = Pos;
+		Pos += aligned;
+
+		return x;
+	}
+
+	void *alloc_bytes_zero(size_t ct)
+	{
+		void *x = alloc_bytes(ct);
+
+		memset(x, 0, ct);
+
+		return x;
+	}
+
+	template <class T> T *alloc_zero()
+	{
+		return static_cast<T *>(alloc_bytes_zero(sizeof(T)));
+	}
+
+	template <class T> T *alloc_array(size_t ct)
+	{
+		return static_cast<T *>(alloc_bytes(sizeof(T) * ct));
+	}
+
+	template <class T> T *alloc_array_zero(size_t ct)
+	{
+		return static_cast<T *>(alloc_bytes_zero(sizeof(T) * ct));
+	}
+
+	//pins a managed object until the region is reset, returning the address of its data
+	//for a String this is the first character; lets large values be passed to ESE without a copy
+	void *pin(System::Object ^o)
+	{
+		using System::Runtime::InteropServices::GCHandle;
+		using System::Runtime::InteropServices::GCHandleType;
+
+		pinned *p = alloc_zero<pinned>(); //allocated first so a failure can't leak the handle
+		GCHandle h = GCHandle::Alloc(o, GCHandleType::Pinned);
+
+		p->Handle = GCHandle::ToIntPtr(h).ToPointer();
+		p->Next = Pins;
+		Pins = p;
+
+		return h.AddrOfPinnedObject().ToPointer();
+	}
+};
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2009 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  scratch_buffer - Growable buffer reused across operations
+///////////////////////////////////////////////////////////////////////////////
+// 
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2009 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//single heap block that only grows, for reuse by repeated operations that need a temporary buffer
+//contents are not preserved when the buffer grows
+class scratch_buffer
+{
+	char *Buff;
+	size_t Size;
+
+	//not copyable, owns Buff
+	scratch_buffer(scratch_buffer const &);
+	scratch_buffer &operator=(scratch_buffer const &);
+
+public:
+	//size of the first allocation, large enough for any fixed size column and most short text
+	static size_t const MinSize = 256;
+
+	scratch_buffer() :
+		Buff(null),
+		Size(0)
+	{}
+
+	//returns a buffer of at least ct bytes, reallocating only if the current one is too small
+	char *reserve(size_t ct)
+	{
+		if(ct > Size || !Buff)
+		{
+			size_t NewSize = Size ? Size : MinSize;
+
+			while(NewSize < ct)
+				NewSize *= 2;
+
+			char *NewBuff = new char[NewSize];
+
+			delete[] Buff;
+			Buff = NewBuff;
+			Size = NewSize;
+		}
+
+		return Buff;
+	}
+
+	//releases the buffer if it has grown beyond max_retain, so one very large value doesn't pin memory for the life of the owner
+	void trim(size_t max_retain)
+	{
+		if(Size > max_retain)
+		{
+			delete[] Buff;
+			Buff = null;
+			Size = 0;
+		}
+	}
+
+	size_t size() const
+	{
+		return Size;
+	}
+
+	~scratch_buffer()
+	{
+		delete[] Buff;
+	}
+};
@@ -0,0 +1,143 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2010 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  Test.DatabaseTest.AllocationBenchmark
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2010 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Diagnostics;
+using NUnit.Framework;
+using EseObjects;
+
+namespace Test.DatabaseTests
+{
+	//allocations per call on the paths that convert values through a region: Update.Set, Update.SetColumns and Retrieve
+	//native counts come from NativeAllocations, managed ones from the GC; small values should fit a region's inline storage and take nothing
+	//not run by default; run it explicitly before and after a change to the allocator and compare the output
+	[TestFixture]
+	[Explicit]
+	[Category("Benchmark")]
+	class AllocationBenchmark
+	{
+		const int Rounds = 1000;
+
+		//calls op Rounds times after warming it up, and prints what each call allocated
+		static void Measure(string what, Action op)
+		{
+			op();
+
+			int heap = NativeAllocations.HeapBlocks;
+			int large = NativeAllocations.LargeBlocks;
+			int chunks = NativeAllocations.ChunksTaken;
+			int gcs = GC.CollectionCount(0);
+			long managed = GC.GetTotalMemory(true);
+			var timer = Stopwatch.StartNew();
+
+			for(int i = 0; i < Rounds; i++)
+				op();
+
+			timer.Stop();
+
+			long managed_after = GC.GetTotalMemory(false);
+			int gcs_after = GC.CollectionCount(0);
+
+			//the managed total is only a count of allocations if nothing was collected meanwhile
+			string managed_per_op = gcs_after == gcs ? ((double)(managed_after - managed) / Rounds).ToString("F1") : "collected";
+
+			Console.WriteLine("{0,-26} heap blocks {1,6:F3}  large {2,6:F3}  chunks {3,6:F3}  managed bytes {4,9}  gen0 GCs {5,3}  {6,8:F3} us",
+				what,
+				(double)(NativeAllocations.HeapBlocks - heap) / Rounds,
+				(double)(NativeAllocations.LargeBlocks - large) / Rounds,
+				(double)(NativeAllocations.ChunksTaken - chunks) / Rounds,
+				managed_per_op,
+				gcs_after - gcs,
+				timer.Elapsed.TotalMilliseconds * 1000 / Rounds);
+		}
+
+		[Test]
+		public void SetAndRetrieve()
+		{
+			string small = new string('s', 40);
+			string medium = new string('m', 400);
+			object d = 1.5;
+			object g = Guid.NewGuid();
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, new Table.CreateOptions
+				{
+					Name = "AllocationBenchmark",
+					Columns = new Column.CreateOptions[]
+					{
+						new Column.CreateOptions("id", Column.Type.Long),
+						new Column.CreateOptions("d", Column.Type.DoubleFloat),
+						new Column.CreateOptions("small", Column.Type.Text, Column.CodePage.Unicode),
+						new Column.CreateOptions("medium", Column.Type.LongText, Column.CodePage.Unicode),
+						new Column.CreateOptions("g", Column.Type.GUID)
+					},
+					Indexes = new Index.CreateOptions[]
+					{
+						new Index.CreateOptions { Name = "PK", KeyColumns = "+id", Unique = true, Primary = true }
+					}
+				}, out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					var values = new object[] {d, small, medium, g};
+					var set_cols = new Column[] {cols[1], cols[2], cols[3], cols[4]};
+
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 0);
+						u.SetColumns(set_cols, values);
+						u.Complete();
+					}
+
+					csr.MoveFirst();
+
+					//values are boxed beforehand, so the managed figures are the conversion's own
+					using(var u = csr.BeginReplace())
+					{
+						Measure("Set double", () => u.Set(cols[1], d));
+						Measure("Set Guid", () => u.Set(cols[4], g));
+						Measure("Set 40 char string", () => u.Set(cols[2], small));
+						Measure("Set 400 char string", () => u.Set(cols[3], medium));
+						Measure("SetColumns 4 columns", () => u.SetColumns(set_cols, values));
+						u.Cancel();
+					}
+
+					Measure("Retrieve double", () => csr.Retrieve<double>(cols[1]));
+					Measure("Retrieve Guid", () => csr.Retrieve<Guid>(cols[4]));
+					Measure("Retrieve 400 char string", () => csr.Retrieve<string>(cols[3]));
+				}
+			}
+		}
+	}
+}
@@ -116,6 +116,94 @@ namespace Test.DatabaseTests
 			}
 		}
 
+		[Test]
+		public void NameLookupFollowsSchemaChanges()
+		{
+			if(!E.I.IsVersionAtLeast(5, 1))
+				Assert.Ignore("Requries 5.1+");
+
+			var tc = Table.CreateOptions.NewWithLists("NameLookupTable");
+			tc.Columns.Add(new Column.CreateOptions("id", Column.Type.Long));
+			tc.Columns.Add(new Column.CreateOptions("val", Column.Type.Long));
+
+			using(var tr = new Transaction(E.S))
+			using(var tab = Table.Create(E.D, tc))
+			using(var csr = new Cursor(tab))
+			{
+				using(var u = csr.BeginInsert())
+				{
+					u.Set("id", 1);
+					u.Set("val", 10);
+					u.Complete();
+				}
+
+				csr.MoveFirst();
+				Assert.That(csr.Retrieve<int>("val"), Is.EqualTo(10));
+
+				//cached lookups must see changes made through the library
+				new Column(tab, "val").RenameColumn(tab, "renamed");
+				Assert.That(csr.Retrieve<int>("renamed"), Is.EqualTo(10));
+
+				try
+				{
+					csr.Retrieve<int>("val");
+					Assert.Fail("Exception expected");
+				}
+				catch(EseException e)
+				{
+					Assert.That(e.Symbol, Is.EqualTo("JET_errColumnNotFound"));
+				}
+
+				Column.Create(tab, new Column.CreateOptions("val", Column.Type.Text, Column.CodePage.Unicode));
+
+				using(var u = csr.BeginReplace())
+				{
+					u.Set("val", "text now");
+					u.Complete();
+				}
+
+				Assert.That(csr.Retrieve<string>("val"), Is.EqualTo("text now"));
+				Assert.That(csr.Retrieve<int>("renamed"), Is.EqualTo(10));
+			}
+		}
+
+		[Test]
+		public void NameLookupFollowsSchemaChangesAfterTableRename()
+		{
+			var tc = Table.CreateOptions.NewWithLists("NameLookupBeforeRename");
+			tc.Columns.Add(new Column.CreateOptions("id", Column.Type.Long));
+
+			using(var tr = new Transaction(E.S))
+			using(var tab = Table.Create(E.D, tc))
+			using(var csr = new Cursor(tab))
+			{
+				using(var u = csr.BeginInsert())
+				{
+					u.Set("id", 1);
+					u.Complete();
+				}
+
+				csr.MoveFirst();
+				Assert.That(csr.Retrieve<int>("id"), Is.EqualTo(1));
+
+				tab.Name = "NameLookupAfterRename";
+
+				//a column added through a table opened under the new name must be visible through the old handle
+				using(var tab2 = new Table(E.D, "NameLookupAfterRename"))
+				{
+					Column.Create(tab2, new Column.CreateOptions("added", Column.Type.Long));
+
+					using(var u = csr.BeginReplace())
+					{
+						u.Set("added", 2);
+						u.Complete();
+					}
+
+					Assert.That(csr.Retrieve<int>("added"), Is.EqualTo(2));
+				}
+			}
+		}
+
 		[Test]
 		public void ColumnTypes()
 		{
@@ -0,0 +1,174 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2010 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  Test.DatabaseTest.CopyRecordsTest
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2010 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using NUnit.Framework;
+using EseObjects;
+
+namespace Test.DatabaseTests
+{
+	[TestFixture]
+	class CopyRecordsTest
+	{
+		static Table.CreateOptions CopyTable(string Name)
+		{
+			return new Table.CreateOptions
+			{
+				Name = Name,
+				Columns = new Column.CreateOptions[]
+				{
+					new Column.CreateOptions("id", Column.Type.Long),
+					new Column.CreateOptions("name", Column.Type.Text, Column.CodePage.Unicode),
+					new Column.CreateOptions("doc", Column.Type.LongBinary),
+					new Column.CreateOptions { Name = "tags", Type = Column.Type.Long, Tagged = true, MultiValued = true }
+				},
+				Indexes = new Index.CreateOptions[]
+				{
+					new Index.CreateOptions { Name = "PK", KeyColumns = "+id", Unique = true, Primary = true }
+				}
+			};
+		}
+
+		[Test]
+		public void CopyRecords()
+		{
+			var doc = new byte[20000];
+			new Random(5).NextBytes(doc);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] src_cols, dest_cols;
+				Index[] ixs;
+
+				using(var src_tab = Table.Create(E.D, CopyTable("CopySource"), out src_cols, out ixs))
+				using(var dest_tab = Table.Create(E.D, CopyTable("CopyDest"), out dest_cols, out ixs))
+				using(var src = new Cursor(src_tab))
+				using(var dest = new Cursor(dest_tab))
+				{
+					var so = new IWriteRecord.SetOptions { TagSequence = 0 };
+
+					for(int i = 0; i < 25; i++)
+						using(var u = src.BeginInsert())
+						{
+							u.Set(src_cols[0], i);
+							u.Set(src_cols[1], i % 5 == 0 ? "" : "name" + i);
+							if(i == 7)
+								u.Set(src_cols[2], doc);
+							for(int t = 0; t < i % 3; t++)
+								u.Set(src_cols[3], i * 100 + t, so);
+							u.Complete();
+						}
+
+					var map = ColumnMapping.ByName(src_cols, dest_cols);
+					Assert.That(map.Count, Is.EqualTo(4));
+
+					//limited count
+					src.MoveFirst();
+					Assert.That(src.CopyRecordsTo(dest, map, 10, 4), Is.EqualTo(10));
+					Assert.That(src.Retrieve<int>(src_cols[0]), Is.EqualTo(10)); //positioned on the first record not copied
+
+					//the rest, to the end of the index
+					Assert.That(src.CopyRecordsTo(dest, map, 0, 4), Is.EqualTo(15));
+
+					dest.MoveFirst();
+					for(int i = 0; i < 25; i++)
+					{
+						Assert.That(dest.Retrieve<int>(dest_cols[0]), Is.EqualTo(i));
+						Assert.That(dest.Retrieve<string>(dest_cols[1]), Is.EqualTo(i % 5 == 0 ? "" : "name" + i));
+						Assert.That(dest.Retrieve<byte[]>(dest_cols[2]), Is.EqualTo(i == 7 ? doc : null));
+
+						var tags = new List<int>();
+						for(int t = 0; t < i % 3; t++)
+							tags.Add(i * 100 + t);
+						Assert.That(dest.RetrieveAllValues<int>(dest_cols[3]), Is.EqualTo(tags.ToArray()));
+
+						Assert.That(dest.Move(1), Is.EqualTo(i < 24));
+					}
+				}
+			}
+		}
+
+		[Test]
+		public void CopyRecordsCommitsEachBatch()
+		{
+			Column[] src_cols, dest_cols;
+			Index[] ixs;
+
+			using(var tr = Transaction.Begin(E.S))
+			{
+				Table.Create(E.D, CopyTable("CopyBatchSource"), out src_cols, out ixs).Dispose();
+				Table.Create(E.D, CopyTable("CopyBatchDest"), out dest_cols, out ixs).Dispose();
+				tr.Commit();
+			}
+
+			try
+			{
+				using(var src_tab = new Table(E.D, "CopyBatchSource"))
+				using(var dest_tab = new Table(E.D, "CopyBatchDest"))
+				using(var src = new Cursor(src_tab))
+				using(var dest = new Cursor(dest_tab))
+				{
+					using(var tr = Transaction.Begin(E.S))
+					{
+						for(int i = 0; i < 8; i++)
+							using(var u = src.BeginInsert())
+							{
+								u.Set(src_cols[0], i);
+								u.Complete();
+							}
+
+						tr.Commit();
+					}
+
+					var map = ColumnMapping.ByName(src_cols, dest_cols);
+
+					//MaxRecords is a multiple of BatchSize: the second batch is the last, with no empty one after it
+					src.MoveFirst();
+					Assert.That(src.CopyRecordsTo(dest, map, 8, 4), Is.EqualTo(8));
+					Assert.That(E.S.CurrentTransaction, Is.Null);
+
+					//no records left, so no batch at all
+					Assert.That(src.CopyRecordsTo(dest, map, 0, 4), Is.EqualTo(0));
+					Assert.That(E.S.CurrentTransaction, Is.Null);
+
+					dest.MoveFirst();
+					Assert.That(dest.ForwardRecordCount(), Is.EqualTo(8));
+				}
+			}
+			finally
+			{
+				Table.Delete(E.D, "CopyBatchSource");
+				Table.Delete(E.D, "CopyBatchDest");
+			}
+		}
+	}
+}
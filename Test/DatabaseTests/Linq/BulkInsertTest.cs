@@ -0,0 +1,113 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2010 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  Test.DatabaseTest.Linq.BulkInsertTest
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2010 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+using NUnit.Framework;
+
+using EseObjects;
+using EseLinq;
+
+namespace Test.DatabaseTests.Linq
+{
+	[TestFixture]
+	class BulkInsertTest
+	{
+		[Test]
+		public void BulkInsertBatches()
+		{
+			using(var tr = Transaction.Begin(E.S))
+			{
+				Table.Create(E.D, new Table.CreateOptions
+				{
+					Name = "BulkABC",
+					Columns = new Column.CreateOptions[]
+					{
+						new Column.CreateOptions("a", Column.Type.Long),
+						new Column.CreateOptions("b", Column.Type.SingleFloat),
+						new Column.CreateOptions("c", Column.Type.LongText, Column.CodePage.English)
+					},
+					Indexes = new Index.CreateOptions[]
+					{
+						Index.CreateOptions.NewPrimary("PK", "+a")
+					}
+				}).Dispose();
+				tr.Commit();
+			}
+
+			try
+			{
+				var rows = Enumerable.Range(0, 250).Select(i => new ABC2 { a = i, b = i / 2.0f, c = "row" + i });
+				var reported = new List<long>();
+				var options = new BulkInsertOptions { BatchSize = 100, Progress = p => reported.Add(p.Rows) };
+				BulkInsertProgress result;
+
+				//outside of any transaction, so each batch is a top level transaction of its own
+				using(var tab = new Table(E.D, "BulkABC"))
+				{
+					result = tab.BulkInsert(rows, new EseLinq.Storage.Flat<ABC2>(tab), options);
+
+					Assert.That(E.S.CurrentTransaction, Is.Null);
+					Assert.That(tab.BulkInsert(new ABC2[0]).Batches, Is.EqualTo(0));
+				}
+
+				Assert.That(result.Rows, Is.EqualTo(250));
+				Assert.That(result.Batches, Is.EqualTo(3));
+				Assert.That(result.RowsPerSecond, Is.GreaterThan(0));
+				Assert.That(reported, Is.EqualTo(new long[] {100, 200, 250}));
+
+				//reopened with nothing rolled back, the rows of every batch are there
+				using(var tab = new Table(E.D, "BulkABC"))
+				using(var csr = new Cursor(tab))
+				{
+					var a = new Column(tab, "a");
+					var c = new Column(tab, "c");
+					int ct = 0;
+
+					for(bool ok = csr.MoveFirst(); ok; ok = csr.Move(1))
+					{
+						Assert.That(csr.Retrieve<int>(a), Is.EqualTo(ct));
+						Assert.That(csr.Retrieve<string>(c), Is.EqualTo("row" + ct));
+						ct++;
+					}
+
+					Assert.That(ct, Is.EqualTo(250));
+				}
+			}
+			finally
+			{
+				Table.Delete(E.D, "BulkABC");
+			}
+		}
+	}
+}
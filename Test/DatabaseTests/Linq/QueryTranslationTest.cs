@@ -0,0 +1,503 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2010 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  Test.DatabaseTest.Linq.QueryTranslationTest
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2010 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Linq.Expressions;
+
+using NUnit.Framework;
+
+using EseObjects;
+using EseLinq;
+
+namespace Test.DatabaseTests.Linq
+{
+	public struct Reading
+	{
+		public int id;
+		public int sensor;
+		public int value;
+		public string note;
+	}
+
+	public struct Tagged
+	{
+		public int id;
+		public int tag;
+		public int grp;
+		public double weight;
+	}
+
+	[TestFixture]
+	class QueryTranslationTest
+	{
+		static Table CreateReadings(string Name, out List<Reading> rows)
+		{
+			Column[] col;
+			Index[] ix;
+
+			var tab = Table.Create(E.D, new Table.CreateOptions
+			{
+				Name = Name,
+				Columns = new Column.CreateOptions[]
+				{
+					new Column.CreateOptions("id", Column.Type.Long),
+					new Column.CreateOptions("sensor", Column.Type.Long),
+					new Column.CreateOptions("value", Column.Type.Long),
+					new Column.CreateOptions("note", Column.Type.LongText, Column.CodePage.Unicode)
+				},
+				Indexes = new Index.CreateOptions[]
+				{
+					Index.CreateOptions.NewPrimary("PK", "+id"),
+					Index.CreateOptions.NewSecondary("BySensor", "+sensor.-value", false)
+				}
+			}, out col, out ix);
+
+			rows = Enumerable.Range(0, 200).Select(i => new Reading { id = i, sensor = i % 5, value = i * 3 % 17, note = "r" + i }).ToList();
+			tab.BulkInsert(rows);
+
+			return tab;
+		}
+
+		//translated query returns the same rows as LINQ to Objects over all of them, in any order
+		static void Check(IQueryable<Reading> src, List<Reading> rows, Expression<Func<Reading, bool>> pred)
+		{
+			var expected = rows.Where(pred.Compile()).Select(r => r.id).OrderBy(i => i).ToArray();
+			var actual = src.Where(pred).AsEnumerable().Select(r => r.id).OrderBy(i => i).ToArray();
+
+			Assert.That(actual, Is.EqualTo(expected), pred.ToString());
+		}
+
+		//lines the provider logs while query runs, describing how it reads the table
+		static string[] Plan(Provider provider, Action query)
+		{
+			var log = new StringWriter();
+
+			provider.Log = log;
+			try
+			{
+				query();
+			}
+			finally
+			{
+				provider.Log = null;
+			}
+
+			return log.ToString().Split(new string[] {Environment.NewLine}, StringSplitOptions.RemoveEmptyEntries);
+		}
+
+		[Test]
+		public void WhereSeek()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				List<Reading> rows;
+
+				using(var tab = CreateReadings("WhereSeek", out rows))
+				{
+					var provider = new Provider(E.S);
+					var src = tab.AsQueryable<Reading>(provider);
+
+					//primary index
+					Check(src, rows, r => r.id == 42);
+					Check(src, rows, r => r.id == 1000);
+					Check(src, rows, r => r.id >= 10 && r.id < 20);
+					Check(src, rows, r => r.id > 190);
+					Check(src, rows, r => 5 <= r.id && r.id <= 7);
+					Check(src, rows, r => r.id < 3 || r.id > 197);
+
+					//secondary index, with a range on a descending column
+					Check(src, rows, r => r.sensor == 2);
+					Check(src, rows, r => r.sensor == 2 && r.value > 4 && r.value <= 10);
+					Check(src, rows, r => r.sensor == 2 && r.value < 4);
+
+					//residual predicate
+					Check(src, rows, r => r.sensor == 3 && r.note.StartsWith("r1"));
+					Check(src, rows, r => r.note == "r7");
+
+					var single = src.Where(r => r.id == 42).ToList();
+					Assert.That(single.Count, Is.EqualTo(1));
+					Assert.That(single[0].note, Is.EqualTo("r42"));
+
+					//successive Where clauses
+					var chained = src.Where(r => r.sensor == 1).Where(r => r.id < 50).AsEnumerable().Select(r => r.id).OrderBy(i => i);
+					Assert.That(chained.ToArray(), Is.EqualTo(new int[] {1, 6, 11, 16, 21, 26, 31, 36, 41, 46}));
+
+					//captured values are read when the query runs
+					int limit = 100;
+					var below = src.Where(r => r.id < limit);
+					limit = 3;
+					Assert.That(below.AsEnumerable().Count(), Is.EqualTo(3));
+
+					//a value that can't be a key falls back to checking every row
+					long big = 5000000000;
+					Assert.That(src.Where(r => r.id < big).AsEnumerable().Count(), Is.EqualTo(200));
+
+					//the index and key range each Where became
+					Assert.That(Plan(provider, () => src.Where(r => r.id == 42).ToList()), Is.EqualTo(new string[] {"read index PK: id = 42"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.id >= 10 && r.id < 20).ToList()), Is.EqualTo(new string[] {"read index PK: id from 10 before 20"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.id > 190).ToList()), Is.EqualTo(new string[] {"read index PK: id from 190; checking rows"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.sensor == 2).ToList()), Is.EqualTo(new string[] {"read index BySensor: sensor = 2"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.sensor == 2 && r.value > 4 && r.value <= 10).ToList()), Is.EqualTo(new string[] {"read index BySensor: sensor = 2, value from 10 before 4"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.sensor == 3 && r.note.StartsWith("r1")).ToList()), Is.EqualTo(new string[] {"read index BySensor: sensor = 3; checking rows"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.sensor == 1).Where(r => r.id < 50).ToList()), Is.EqualTo(new string[] {"read index BySensor: sensor = 1; checking rows"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.note == "r7").ToList()), Is.EqualTo(new string[] {"read primary index; checking rows"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.id < 3 || r.id > 197).ToList()), Is.EqualTo(new string[] {"read primary index; checking rows"}));
+				}
+			}
+		}
+
+		//tag is multivalued, grp is only indexed where flag is set and weight has a -0.0
+		static Table CreateTagged(string Name, out List<Tagged> rows)
+		{
+			Column[] col;
+			Index[] ix;
+
+			var tab = Table.Create(E.D, new Table.CreateOptions
+			{
+				Name = Name,
+				Columns = new Column.CreateOptions[]
+				{
+					new Column.CreateOptions("id", Column.Type.Long),
+					new Column.CreateOptions { Name = "tag", Type = Column.Type.Long, Tagged = true, MultiValued = true },
+					new Column.CreateOptions("grp", Column.Type.Long),
+					new Column.CreateOptions { Name = "flag", Type = Column.Type.Long, Tagged = true },
+					new Column.CreateOptions("weight", Column.Type.DoubleFloat)
+				},
+				Indexes = new Index.CreateOptions[]
+				{
+					Index.CreateOptions.NewPrimary("PK", "+id"),
+					Index.CreateOptions.NewSecondary("ByTag", "+tag", false),
+					new Index.CreateOptions
+					{
+						Name = "ByGroup",
+						KeyColumns = "+grp",
+						ConditionalColumns = new Index.ConditionalColumn[] {new Index.ConditionalColumn {Name = "flag", MustBeNonNull = true}}
+					},
+					Index.CreateOptions.NewSecondary("ByWeight", "+weight", false)
+				}
+			}, out col, out ix);
+
+			Assert.That(ix[1].KeyColumns.Single().MultiValued, Is.True);
+			Assert.That(ix[2].ConditionalColumns.Single().MustBeNonNull, Is.True);
+
+			rows = Enumerable.Range(0, 60).Select(i => new Tagged { id = i, tag = i % 4, grp = i % 5, weight = i == 7 ? -0.0 : i % 10 }).ToList();
+
+			var so = new IWriteRecord.SetOptions { TagSequence = 0 };
+
+			using(var cur = new Cursor(tab))
+				foreach(Tagged r in rows)
+					using(var u = cur.BeginInsert())
+					{
+						u.Set(col[0], r.id);
+						u.Set(col[1], r.tag, so);
+						if(r.id % 3 == 0)
+							u.Set(col[1], r.tag + 1, so); //second index entry
+						u.Set(col[2], r.grp);
+						if(r.id % 2 == 0)
+							u.Set(col[3], 1);
+						u.Set(col[4], r.weight);
+						u.Complete();
+					}
+
+			return tab;
+		}
+
+		static int[] SortedIds(IEnumerable<Tagged> rows)
+		{
+			return rows.Select(r => r.id).OrderBy(i => i).ToArray();
+		}
+
+		[Test]
+		public void IndexesNotCoveringEachRowOnce()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				List<Tagged> rows;
+
+				using(var tab = CreateTagged("IndexesNotCoveringEachRowOnce", out rows))
+				{
+					var provider = new Provider(E.S);
+					var src = tab.AsQueryable<Tagged>(provider);
+
+					//the catalog reports what rules the indexes out
+					var ixs = tab.Indexes.ToDictionary(ix => ix.IndexName);
+					Assert.That(ixs["ByTag"].KeyColumns.Single().MultiValued, Is.True);
+					Assert.That(ixs["PK"].KeyColumns.Single().MultiValued, Is.False);
+					if(ixs["PK"].ConditionalColumns != null) //read from the catalog on 6.1+
+					{
+						Assert.That(ixs["PK"].ConditionalColumns, Is.Empty);
+						Assert.That(ixs["ByGroup"].ConditionalColumns.Single().Name, Is.EqualTo("flag"));
+					}
+
+					//multivalued key: a seek would find rows by their second tag, and list them twice
+					Assert.That(SortedIds(src.Where(r => r.tag == 1)), Is.EqualTo(SortedIds(rows.Where(r => r.tag == 1))));
+					Assert.That(SortedIds(src.Where(r => r.tag >= 2 && r.tag < 4)), Is.EqualTo(SortedIds(rows.Where(r => r.tag >= 2 && r.tag < 4))));
+					Assert.That(src.OrderBy(r => r.tag).Select(r => r.tag).ToArray(), Is.EqualTo(rows.OrderBy(r => r.tag).Select(r => r.tag).ToArray()));
+					Assert.That(src.OrderBy(r => r.tag).Count(), Is.EqualTo(60));
+					Assert.That(src.Count(r => r.tag == 1), Is.EqualTo(rows.Count(r => r.tag == 1)));
+
+					//conditional index: rows without flag are missing from it
+					Assert.That(SortedIds(src.Where(r => r.grp == 3)), Is.EqualTo(SortedIds(rows.Where(r => r.grp == 3))));
+					Assert.That(src.OrderBy(r => r.grp).Select(r => r.grp).ToArray(), Is.EqualTo(rows.OrderBy(r => r.grp).Select(r => r.grp).ToArray()));
+					Assert.That(src.Count(r => r.grp == 3), Is.EqualTo(12));
+					Assert.That(src.Any(r => r.grp == 3 && r.id > 0 && r.id < 5), Is.True);
+
+					//-0.0 equals 0.0 but has a key of its own
+					Assert.That(SortedIds(src.Where(r => r.weight == 0.0)), Is.EqualTo(new int[] {0, 7, 10, 20, 30, 40, 50}));
+					Assert.That(SortedIds(src.Where(r => r.weight >= 0.0 && r.weight < 1.0)), Is.EqualTo(new int[] {0, 7, 10, 20, 30, 40, 50}));
+					Assert.That(SortedIds(src.Where(r => r.weight <= 0.0)), Is.EqualTo(new int[] {0, 7, 10, 20, 30, 40, 50}));
+					Assert.That(src.Count(r => r.weight == -0.0), Is.EqualTo(7));
+					Assert.That(src.OrderBy(r => r.weight).Select(r => r.weight).ToArray(), Is.EqualTo(rows.OrderBy(r => r.weight).Select(r => r.weight).ToArray()));
+
+					//none of them are read
+					Assert.That(Plan(provider, () => src.Where(r => r.tag == 1).ToList()), Is.EqualTo(new string[] {"read primary index; checking rows"}));
+					Assert.That(Plan(provider, () => src.Count(r => r.grp == 3)), Is.EqualTo(new string[] {"read primary index; checking rows", "retrieve grp", "60 rows read"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.weight == 0.0).ToList()), Is.EqualTo(new string[] {"read primary index; checking rows"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.id < 10 && r.weight == 0.0).ToList()), Is.EqualTo(new string[] {"read index PK: id before 10; checking rows"}));
+				}
+			}
+		}
+
+		//sort keys of each row in order, ignoring the order of rows with equal keys
+		static string[] Keys(IEnumerable<Reading> rows, Func<Reading, string> key)
+		{
+			return rows.Select(key).ToArray();
+		}
+
+		[Test]
+		public void OrderByIndex()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				List<Reading> rows;
+
+				using(var tab = CreateReadings("OrderByIndex", out rows))
+				{
+					var provider = new Provider(E.S);
+					var src = tab.AsQueryable<Reading>(provider);
+					Func<Reading, string> id = r => r.id.ToString();
+					Func<Reading, string> sv = r => r.sensor + "/" + r.value;
+
+					//primary index, forward and backward
+					Assert.That(Keys(src.OrderBy(r => r.id), id), Is.EqualTo(Keys(rows.OrderBy(r => r.id), id)));
+					Assert.That(Keys(src.OrderByDescending(r => r.id), id), Is.EqualTo(Keys(rows.OrderByDescending(r => r.id), id)));
+					Assert.That(Keys(src.Where(r => r.id >= 10 && r.id < 20).OrderByDescending(r => r.id), id), Is.EqualTo(Keys(rows.Where(r => r.id >= 10 && r.id < 20).OrderByDescending(r => r.id), id)));
+					Assert.That(Keys(src.OrderByDescending(r => r.id).Where(r => r.id > 10 && r.id <= 20), id), Is.EqualTo(Keys(rows.Where(r => r.id > 10 && r.id <= 20).OrderByDescending(r => r.id), id)));
+
+					//secondary index with a descending key column
+					Assert.That(Keys(src.OrderBy(r => r.sensor).ThenByDescending(r => r.value), sv), Is.EqualTo(Keys(rows.OrderBy(r => r.sensor).ThenByDescending(r => r.value), sv)));
+					Assert.That(Keys(src.OrderByDescending(r => r.sensor).ThenBy(r => r.value), sv), Is.EqualTo(Keys(rows.OrderByDescending(r => r.sensor).ThenBy(r => r.value), sv)));
+					Assert.That(Keys(src.Where(r => r.sensor == 2).OrderBy(r => r.value), sv), Is.EqualTo(Keys(rows.Where(r => r.sensor == 2).OrderBy(r => r.value), sv)));
+					Assert.That(Keys(src.Where(r => r.sensor == 2 && r.value > 3 && r.value < 12).OrderBy(r => r.value), sv), Is.EqualTo(Keys(rows.Where(r => r.sensor == 2 && r.value > 3 && r.value < 12).OrderBy(r => r.value), sv)));
+					Assert.That(Keys(src.OrderBy(r => r.value).Where(r => r.sensor == 2), sv), Is.EqualTo(Keys(rows.Where(r => r.sensor == 2).OrderBy(r => r.value), sv)));
+
+					//no matching index, so rows are sorted
+					Assert.That(Keys(src.OrderBy(r => r.sensor).ThenBy(r => r.value), sv), Is.EqualTo(Keys(rows.OrderBy(r => r.sensor).ThenBy(r => r.value), sv)));
+					Assert.That(Keys(src.OrderBy(r => r.note, StringComparer.Ordinal), r => r.note), Is.EqualTo(Keys(rows.OrderBy(r => r.note, StringComparer.Ordinal), r => r.note)));
+					Assert.That(Keys(src.OrderBy(r => r.id % 7).ThenByDescending(r => r.id), id), Is.EqualTo(Keys(rows.OrderBy(r => r.id % 7).ThenByDescending(r => r.id), id)));
+
+					//top N
+					Assert.That(Keys(src.OrderByDescending(r => r.id).Take(3), id), Is.EqualTo(new string[] {"199", "198", "197"}));
+
+					//read in index order rather than sorted
+					Assert.That(Plan(provider, () => src.OrderBy(r => r.id).ToList()), Is.EqualTo(new string[] {"read index PK"}));
+					Assert.That(Plan(provider, () => src.OrderByDescending(r => r.id).Take(3).ToList()), Is.EqualTo(new string[] {"read index PK backward"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.id >= 10 && r.id < 20).OrderByDescending(r => r.id).ToList()), Is.EqualTo(new string[] {"read index PK backward: id from 10 before 20; checking rows"}));
+					Assert.That(Plan(provider, () => src.OrderBy(r => r.sensor).ThenByDescending(r => r.value).ToList()), Is.EqualTo(new string[] {"read index BySensor"}));
+					Assert.That(Plan(provider, () => src.OrderByDescending(r => r.sensor).ThenBy(r => r.value).ToList()), Is.EqualTo(new string[] {"read index BySensor backward"}));
+					Assert.That(Plan(provider, () => src.OrderBy(r => r.value).Where(r => r.sensor == 2).ToList()), Is.EqualTo(new string[] {"read index BySensor backward: sensor = 2"}));
+
+					Assert.That(Plan(provider, () => src.OrderBy(r => r.sensor).ThenBy(r => r.value).ToList()), Is.EqualTo(new string[] {"sort rows", "read primary index"}));
+					Assert.That(Plan(provider, () => src.OrderBy(r => r.note, StringComparer.Ordinal).ToList()), Is.EqualTo(new string[] {"sort rows", "read primary index"}));
+				}
+			}
+		}
+
+		[Test]
+		public void SelectColumns()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				List<Reading> rows;
+
+				using(var tab = CreateReadings("SelectColumns", out rows))
+				{
+					var provider = new Provider(E.S);
+					var src = tab.AsQueryable<Reading>(provider);
+
+					Assert.That(src.Select(r => r.note).ToArray(), Is.EqualTo(rows.Select(r => r.note).ToArray()));
+
+					//members read by predicates and sort keys are retrieved too
+					var narrowed = src.Where(r => r.note.EndsWith("7")).OrderBy(r => r.value).Select(r => r.id + "," + r.note.Length);
+					var expected = rows.Where(r => r.note.EndsWith("7")).OrderBy(r => r.value).Select(r => r.id + "," + r.note.Length);
+					Assert.That(narrowed.ToArray(), Is.EquivalentTo(expected.ToArray()));
+
+					var pairs = src.Where(r => r.sensor == 4).Select(r => new { r.id, r.value }).ToArray();
+					Assert.That(pairs.Length, Is.EqualTo(40));
+					Assert.That(pairs.All(p => p.value == p.id * 3 % 17));
+
+					//whole rows
+					Assert.That(src.Select(r => r).Count(), Is.EqualTo(200));
+					Assert.That(src.Select(r => r.ToString()).Count(), Is.EqualTo(200));
+					Assert.That(src.Select((r, i) => r.id - i).Distinct().ToArray(), Is.EqualTo(new int[] {0}));
+
+					//columns retrieved: the selector's members, then those of predicates and sort keys
+					Assert.That(Plan(provider, () => src.Select(r => r.note).ToArray()), Is.EqualTo(new string[] {"read primary index", "retrieve note"}));
+					Assert.That(Plan(provider, () => narrowed.ToArray()), Is.EqualTo(new string[] {"sort rows", "read primary index; checking rows", "retrieve id, note, value"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.sensor == 4).Select(r => new { r.id, r.value }).ToArray()), Is.EqualTo(new string[] {"read index BySensor: sensor = 4", "retrieve id, value, sensor"}));
+					Assert.That(Plan(provider, () => src.Select(r => r.ToString()).ToArray()), Is.EqualTo(new string[] {"read primary index"}));
+				}
+			}
+		}
+
+		[Test]
+		public void CountAny()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				List<Reading> rows;
+
+				using(var tab = CreateReadings("CountAny", out rows))
+				{
+					var provider = new Provider(E.S);
+					var src = tab.AsQueryable<Reading>(provider);
+
+					//counted from index entries
+					Assert.That(src.Count(), Is.EqualTo(200));
+					Assert.That(src.Count(r => r.id < 50), Is.EqualTo(50));
+					Assert.That(src.LongCount(r => r.sensor == 3 && r.value >= 4), Is.EqualTo(rows.LongCount(r => r.sensor == 3 && r.value >= 4)));
+					Assert.That(src.OrderByDescending(r => r.id).Count(r => r.sensor == 1), Is.EqualTo(40));
+					Assert.That(src.Any(), Is.True);
+					Assert.That(src.Any(r => r.id == 10), Is.True);
+					Assert.That(src.Any(r => r.id == 1000), Is.False);
+
+					//rows read to check the rest of the predicate
+					Assert.That(src.Where(r => r.sensor == 3).Count(r => r.value > 4), Is.EqualTo(rows.Count(r => r.sensor == 3 && r.value > 4)));
+					Assert.That(src.Count(r => r.note.EndsWith("9")), Is.EqualTo(20));
+					Assert.That(src.Any(r => r.note == "r5"), Is.True);
+					Assert.That(src.Any(r => r.note == "x"), Is.False);
+
+					//index entries counted without reading rows
+					Assert.That(Plan(provider, () => src.Count()), Is.EqualTo(new string[] {"read primary index", "count entries"}));
+					Assert.That(Plan(provider, () => src.Count(r => r.id < 50)), Is.EqualTo(new string[] {"read index PK: id before 50", "count entries"}));
+					Assert.That(Plan(provider, () => src.LongCount(r => r.sensor == 3 && r.value >= 4)), Is.EqualTo(new string[] {"read index BySensor: sensor = 3, value to 4", "count entries"}));
+					Assert.That(Plan(provider, () => src.OrderByDescending(r => r.id).Count(r => r.sensor == 1)), Is.EqualTo(new string[] {"read index BySensor: sensor = 1", "count entries"}));
+					Assert.That(Plan(provider, () => src.Any()), Is.EqualTo(new string[] {"read primary index", "count entries"}));
+					Assert.That(Plan(provider, () => src.Any(r => r.id == 10)), Is.EqualTo(new string[] {"read index PK: id = 10", "count entries"}));
+					Assert.That(Plan(provider, () => src.Any(r => r.id == 1000)), Is.EqualTo(new string[] {"read index PK: id = 1000"}));
+
+					//rows read, retrieving only what the predicates need; Any stops at the first match
+					Assert.That(Plan(provider, () => src.Where(r => r.sensor == 3).Count(r => r.value > 4)), Is.EqualTo(new string[] {"read index BySensor: sensor = 3; checking rows", "retrieve sensor, value", "40 rows read"}));
+					Assert.That(Plan(provider, () => src.Count(r => r.note.EndsWith("9"))), Is.EqualTo(new string[] {"read primary index; checking rows", "retrieve note", "200 rows read"}));
+					Assert.That(Plan(provider, () => src.Any(r => r.note == "r5")), Is.EqualTo(new string[] {"read primary index; checking rows", "retrieve note", "6 rows read"}));
+				}
+			}
+		}
+
+		static int[] Ids(IEnumerable<Reading> rows)
+		{
+			return rows.Select(r => r.id).ToArray();
+		}
+
+		[Test]
+		public void SkipTake()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				List<Reading> rows;
+
+				using(var tab = CreateReadings("SkipTake", out rows))
+				{
+					var provider = new Provider(E.S);
+					var src = tab.AsQueryable<Reading>(provider);
+
+					//moved past without reading
+					Assert.That(Ids(src.Skip(10).Take(5)), Is.EqualTo(Ids(rows.Skip(10).Take(5))));
+					Assert.That(Ids(src.OrderByDescending(r => r.id).Skip(10).Take(5)), Is.EqualTo(Ids(rows.OrderByDescending(r => r.id).Skip(10).Take(5))));
+					Assert.That(Ids(src.Where(r => r.id >= 50 && r.id < 100).Skip(10).Take(5)), Is.EqualTo(Ids(rows.Where(r => r.id >= 50 && r.id < 100).Skip(10).Take(5))));
+					Assert.That(Ids(src.Skip(195).Take(20)), Is.EqualTo(Ids(rows.Skip(195).Take(20))));
+					Assert.That(Ids(src.Skip(500)), Is.Empty);
+
+					//rows checked or sorted first
+					Assert.That(Ids(src.Where(r => r.note.EndsWith("3")).Skip(4).Take(3)), Is.EqualTo(Ids(rows.Where(r => r.note.EndsWith("3")).Skip(4).Take(3))));
+					Assert.That(Ids(src.OrderBy(r => r.note, StringComparer.Ordinal).Skip(4).Take(3)), Is.EqualTo(Ids(rows.OrderBy(r => r.note, StringComparer.Ordinal).Skip(4).Take(3))));
+
+					//combinations, and operators applied to a page
+					Assert.That(Ids(src.Take(10).Skip(3)), Is.EqualTo(Ids(rows.Take(10).Skip(3))));
+					Assert.That(Ids(src.Skip(3).Skip(4).Take(20).Take(2)), Is.EqualTo(Ids(rows.Skip(3).Skip(4).Take(20).Take(2))));
+					Assert.That(Ids(src.Take(10).Where(r => r.id > 5)), Is.EqualTo(Ids(rows.Take(10).Where(r => r.id > 5))));
+					Assert.That(Ids(src.Take(10).OrderByDescending(r => r.id)), Is.EqualTo(Ids(rows.Take(10).OrderByDescending(r => r.id))));
+
+					Assert.That(src.Skip(10).Take(5).Count(), Is.EqualTo(5));
+					Assert.That(src.Skip(190).Count(), Is.EqualTo(10));
+					Assert.That(src.Take(10).Count(r => r.id > 5), Is.EqualTo(4));
+					Assert.That(src.Skip(200).Any(), Is.False);
+
+					//counts made from captured variables, as in a query built inside a lambda, are read when the query runs
+					int page = 2, size = 10;
+					Expression<Func<int>> skip_count = () => page * size;
+					Expression<Func<int>> take_count = () => size;
+					var skipped = provider.CreateQuery<Reading>(Expression.Call(typeof(Queryable), "Skip", new Type[] {typeof(Reading)}, src.Expression, skip_count.Body));
+					var paged = provider.CreateQuery<Reading>(Expression.Call(typeof(Queryable), "Take", new Type[] {typeof(Reading)}, skipped.Expression, take_count.Body));
+
+					page = 3;
+					Assert.That(Ids(paged), Is.EqualTo(Ids(rows.Skip(30).Take(10))));
+					Assert.That(Plan(provider, () => paged.ToList()), Is.EqualTo(new string[] {"read primary index", "skip 30 entries"}));
+					page = 1;
+					size = 5;
+					Assert.That(Ids(paged), Is.EqualTo(Ids(rows.Skip(5).Take(5))));
+					Assert.That(paged.Count(), Is.EqualTo(5));
+
+					//approximate positioning starts near the requested row
+					var approx_provider = new Provider(E.S) {ApproximateSkipThreshold = 100};
+					var approx = tab.AsQueryable<Reading>(approx_provider);
+					int first = approx.Skip(150).First().id;
+					Assert.That(first, Is.InRange(130, 170));
+
+					//entries moved past without reading rows
+					Assert.That(Plan(provider, () => src.Skip(10).Take(5).ToList()), Is.EqualTo(new string[] {"read primary index", "skip 10 entries"}));
+					Assert.That(Plan(provider, () => src.OrderByDescending(r => r.id).Skip(10).Take(5).ToList()), Is.EqualTo(new string[] {"read index PK backward", "skip 10 entries"}));
+					Assert.That(Plan(provider, () => src.Where(r => r.id >= 50 && r.id < 100).Skip(10).Take(5).ToList()), Is.EqualTo(new string[] {"read index PK: id from 50 before 100", "skip 10 entries"}));
+					Assert.That(Plan(provider, () => src.Skip(190).Count()), Is.EqualTo(new string[] {"read primary index", "skip 190 entries", "count entries"}));
+					Assert.That(Plan(approx_provider, () => approx.Skip(150).Take(3).ToList()), Is.EqualTo(new string[] {"read primary index", "skip about 150 entries"}));
+					Assert.That(Plan(approx_provider, () => approx.Skip(50).Take(3).ToList()), Is.EqualTo(new string[] {"read primary index", "skip 50 entries"}));
+
+					//rows checked while skipping, or sorted and then skipped in memory
+					Assert.That(Plan(provider, () => src.Where(r => r.note.EndsWith("3")).Skip(4).Take(3).ToList()), Is.EqualTo(new string[] {"read primary index; checking rows", "retrieve note", "skip rows, 34 read"}));
+					Assert.That(Plan(provider, () => src.OrderBy(r => r.note, StringComparer.Ordinal).Skip(4).Take(3).ToList()), Is.EqualTo(new string[] {"sort rows", "read primary index"}));
+				}
+			}
+		}
+	}
+}
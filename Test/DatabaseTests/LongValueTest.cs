@@ -0,0 +1,438 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2010 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  Test.DatabaseTest.LongValueTest
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2010 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.IO;
+using NUnit.Framework;
+using EseObjects;
+using EseLinq.Storage;
+
+namespace Test.DatabaseTests
+{
+	class CompressedDoc
+	{
+		public int id;
+		[CompressedField(MinSize = 64)]
+		public string text;
+	}
+
+	[TestFixture]
+	class LongValueTest
+	{
+		static Table.CreateOptions BlobTable(string Name)
+		{
+			return new Table.CreateOptions
+			{
+				Name = Name,
+				Columns = new Column.CreateOptions[]
+				{
+					new Column.CreateOptions("id", Column.Type.Long),
+					new Column.CreateOptions("blob", Column.Type.LongBinary)
+				},
+				Indexes = new Index.CreateOptions[]
+				{
+					new Index.CreateOptions { Name = "PK", KeyColumns = "+id", Unique = true, Primary = true }
+				}
+			};
+		}
+
+		static byte[] Pattern(int Length)
+		{
+			var data = new byte[Length];
+
+			for(int i = 0; i < Length; i++)
+				data[i] = (byte)(i * 7 + i / 251);
+
+			return data;
+		}
+
+		[Test]
+		public void ReadStream()
+		{
+			var data = Pattern(300000);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, BlobTable("LVReadStream"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 1);
+						u.Set(cols[1], data);
+						u.Complete();
+					}
+
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 2);
+						u.Complete();
+					}
+
+					csr.MoveFirst();
+
+					using(var s = csr.OpenLongValueReader(cols[1]))
+					{
+						Assert.That(s.CanRead && s.CanSeek && !s.CanWrite);
+						Assert.That(s.Length, Is.EqualTo(data.Length));
+
+						//small reads through the buffer
+						var small = new byte[100];
+						Assert.That(s.Read(small, 0, small.Length), Is.EqualTo(small.Length));
+						for(int i = 0; i < small.Length; i++)
+							Assert.That(small[i], Is.EqualTo(data[i]));
+
+						//seek and read across the end
+						s.Seek(-10, SeekOrigin.End);
+						Assert.That(s.Read(small, 0, small.Length), Is.EqualTo(10));
+						Assert.That(small[9], Is.EqualTo(data[data.Length - 1]));
+						Assert.That(s.Read(small, 0, small.Length), Is.EqualTo(0));
+
+						//whole value with reads larger than the buffer
+						s.Position = 0;
+						var all = new MemoryStream();
+						var chunk = new byte[100000];
+						int ct;
+
+						while((ct = s.Read(chunk, 0, chunk.Length)) > 0)
+							all.Write(chunk, 0, ct);
+
+						Assert.That(all.ToArray(), Is.EqualTo(data));
+					}
+
+					csr.Move(1);
+
+					using(var s = csr.OpenLongValueReader(cols[1]))
+						Assert.That(s.Length, Is.EqualTo(0)); //null
+				}
+			}
+		}
+
+		static byte[] ReadAll(Cursor csr, Column col)
+		{
+			using(var s = csr.OpenLongValueReader(col))
+			{
+				var data = new byte[s.Length];
+				int pos = 0, ct;
+
+				while((ct = s.Read(data, pos, data.Length - pos)) > 0)
+					pos += ct;
+
+				return data;
+			}
+		}
+
+		[Test]
+		public void WriteStream()
+		{
+			var data = Pattern(200000);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, BlobTable("LVWriteStream"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					//mixed small and large writes, no preallocation
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 1);
+
+						using(var s = u.OpenLongValueWriter(cols[1]))
+						{
+							s.Write(data, 0, 10);
+							s.Write(data, 10, 100000);
+							s.Write(data, 100010, data.Length - 100010);
+						}
+
+						u.CompleteSeek();
+					}
+
+					Assert.That(ReadAll(csr, cols[1]), Is.EqualTo(data));
+
+					//preallocated larger than written, trimmed on close
+					using(var u = csr.BeginReplace())
+					{
+						using(var s = u.OpenLongValueWriter(cols[1], data.Length * 2))
+							s.Write(data, 0, 1000);
+
+						u.Complete();
+					}
+
+					var prefix = new byte[1000];
+					Array.Copy(data, prefix, prefix.Length);
+					Assert.That(ReadAll(csr, cols[1]), Is.EqualTo(prefix));
+
+					//preallocated smaller than written, and finished by Complete without closing
+					using(var u = csr.BeginReplace())
+					{
+						var s = u.OpenLongValueWriter(cols[1], 5000);
+						s.Write(data, 0, data.Length);
+						u.Complete();
+					}
+
+					Assert.That(ReadAll(csr, cols[1]), Is.EqualTo(data));
+
+					using(var u = csr.BeginReplace())
+					{
+						u.SetLongValueSize(cols[1], 10);
+						u.Complete();
+					}
+
+					Assert.That(ReadAll(csr, cols[1]).Length, Is.EqualTo(10));
+				}
+			}
+		}
+
+		[Test]
+		public void RetrieveBytes()
+		{
+			//small ones are copied, large ones pinned on write and retrieved directly into the result
+			int[] sizes = {0, 1, 255, 256, 5000, 300000};
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, BlobTable("LVRetrieveBytes"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					foreach(int size in sizes)
+					{
+						using(var u = csr.BeginInsert())
+						{
+							u.Set(cols[0], size);
+							u.Set(cols[1], Pattern(size));
+							u.Complete();
+						}
+					}
+
+					foreach(int size in sizes)
+					{
+						Assert.That(csr.Seek(cols[0], size));
+						Assert.That(csr.Retrieve<byte[]>(cols[1]), Is.EqualTo(Pattern(size)));
+					}
+
+					//partial retrieval larger than the scratch buffer
+					var ro = new IReadRecord.RetrieveOptions {SizeLimit = 100000};
+					var prefix = new byte[100000];
+					Array.Copy(Pattern(300000), prefix, prefix.Length);
+					Assert.That(csr.Retrieve<byte[]>(cols[1], ro), Is.EqualTo(prefix));
+				}
+			}
+		}
+
+		[Test]
+		public void Compression()
+		{
+			var json = new System.Text.StringBuilder();
+
+			for(int i = 0; i < 2000; i++)
+				json.AppendFormat("{{\"id\":{0},\"name\":\"customer {0}\",\"active\":true}},", i);
+
+			string text = json.ToString();
+			byte[] magic = new byte[] {0xE5, (byte)'L', (byte)'Z', 1, 2, 3}; //looks like a compressed value
+			byte[] random = new byte[5000];
+			new Random(1).NextBytes(random);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+				var opts = BlobTable("LVCompression");
+
+				opts.Columns = new Column.CreateOptions[]
+				{
+					opts.Columns[0],
+					opts.Columns[1],
+					new Column.CreateOptions("text", Column.Type.LongText, Column.CodePage.Unicode)
+				};
+
+				using(var tab = Table.Create(E.D, opts, out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					var blob = new Column(tab, "blob") {CompressionThreshold = 64};
+					var ctext = new Column(tab, "text") {CompressionThreshold = 64};
+
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 1);
+						u.Set(blob, magic);
+						u.Set(ctext, text);
+						u.Complete();
+					}
+
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 2);
+						u.Set(blob, random);
+						u.Complete();
+					}
+
+					Assert.That(csr.Seek(cols[0], 1));
+
+					//text is stored compressed and read back through Column objects with compression enabled
+					Assert.That(ReadAll(csr, cols[2]).Length, Is.LessThan(text.Length * 2 / 3));
+					Assert.That(csr.Retrieve<string>(ctext), Is.EqualTo(text));
+					Assert.That(csr.RetrieveColumns(new ColumnSet(new Column[] {ctext}))[0], Is.EqualTo(text));
+
+					//a short value that happens to start like a compressed one reads back as written
+					Assert.That(csr.Retrieve<byte[]>(blob), Is.EqualTo(magic));
+
+					//values that don't compress are stored as is
+					Assert.That(csr.Seek(cols[0], 2));
+					Assert.That(ReadAll(csr, cols[1]), Is.EqualTo(random));
+					Assert.That(csr.Retrieve<byte[]>(blob), Is.EqualTo(random));
+				}
+			}
+		}
+
+		[Test]
+		public void CompressionSharedByColumnObjects()
+		{
+			var text = new System.Text.StringBuilder();
+
+			for(int i = 0; i < 200; i++)
+				text.AppendFormat("line {0} of a document that compresses well\n", i);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+				var opts = BlobTable("LVCompressionShared");
+
+				opts.Columns = new Column.CreateOptions[]
+				{
+					opts.Columns[0],
+					new Column.CreateOptions("text", Column.Type.LongText, Column.CodePage.Unicode)
+				};
+
+				using(var tab = Table.Create(E.D, opts, out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					//the attribute enables compression for the column, not just the Flat's own Column object
+					var flat = new Flat<CompressedDoc>(tab);
+
+					Assert.AreEqual(64, new Column(tab, "text").CompressionThreshold);
+					Assert.AreEqual(64, cols[1].CompressionThreshold);
+
+					using(var u = csr.BeginInsert())
+					{
+						flat.Write(u, new CompressedDoc {id = 1, text = text.ToString()});
+						u.Complete();
+					}
+
+					//written by name, which goes through the schema cache
+					using(var u = csr.BeginInsert())
+					{
+						u.Set("id", 2);
+						u.Set("text", text.ToString());
+						u.Complete();
+					}
+
+					foreach(int id in new int[] {1, 2})
+					{
+						Assert.That(csr.Seek(cols[0], id));
+						Assert.That(ReadAll(csr, cols[1]).Length, Is.LessThan(text.Length * 2 / 3));
+
+						Assert.That(csr.Retrieve<string>("text"), Is.EqualTo(text.ToString()));
+						Assert.That(flat.Read(csr).text, Is.EqualTo(text.ToString()));
+
+						//RetrieveAllFields with the cached column map and with a copy of it
+						foreach(var fields in new Field[][] {csr.RetrieveAllFields(), csr.RetrieveAllFields(0, csr.ColumnMap)})
+						{
+							string all = null;
+
+							foreach(var f in fields)
+								if(f.Col.Name == "text")
+									all = (string)f.Val;
+
+							Assert.That(all, Is.EqualTo(text.ToString()));
+						}
+					}
+
+					//changed through any Column object, the setting changes for all of them
+					csr.ColumnMap[cols[1].JetColumnID].CompressionThreshold = 0;
+					Assert.AreEqual(0, new Column(tab, "text").CompressionThreshold);
+				}
+			}
+		}
+
+		[Test]
+		public void CompressionLeavesOtherColumnsAlone()
+		{
+			//existing data that starts like a stored frame, written without compression as it always was
+			byte[] legacy = new byte[] {0xE5, (byte)'L', (byte)'Z', 0, 1, 2, 3, 4};
+			//a compressed frame header claiming a 2GB value
+			byte[] bogus = new byte[] {0xE5, (byte)'L', (byte)'Z', 1, 0xFF, 0xFF, 0xFF, 0x7F, 9};
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, BlobTable("LVNoCompression"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 1);
+						u.Set(cols[1], legacy);
+						u.Complete();
+					}
+
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 2);
+						u.Set(cols[1], bogus);
+						u.Complete();
+					}
+
+					//without compression enabled, values are written and read exactly as they are
+					Assert.That(csr.Seek(cols[0], 1));
+					Assert.That(ReadAll(csr, cols[1]), Is.EqualTo(legacy));
+					Assert.That(csr.Retrieve<byte[]>(cols[1]), Is.EqualTo(legacy));
+					Assert.That(csr.RetrieveColumns(new ColumnSet(new Column[] {cols[1]}))[0], Is.EqualTo(legacy));
+
+					//a size that can't come from the stored bytes isn't trusted, the value is returned as stored
+					Assert.That(csr.Seek(cols[0], 2));
+					Assert.That(csr.Retrieve<byte[]>(new Column(tab, "blob") {CompressionThreshold = 64}), Is.EqualTo(bogus));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,613 @@
+﻿///////////////////////////////////////////////////////////////////////////////
+// Project     :  EseLinq http://code.google.com/p/eselinq/
+// Copyright   :  (c) 2010 Christopher Smith
+// Maintainer  :  csmith32@gmail.com
+// Module      :  Test.DatabaseTest.RetrieveTest
+///////////////////////////////////////////////////////////////////////////////
+//
+//This software is licenced under the terms of the MIT License:
+//
+//Copyright (c) 2010 Christopher Smith
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in
+//all copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using NUnit.Framework;
+using EseObjects;
+
+namespace Test.DatabaseTests
+{
+	[TestFixture]
+	class RetrieveTest
+	{
+		static Table.CreateOptions WideTable(string Name)
+		{
+			return new Table.CreateOptions
+			{
+				Name = Name,
+				Columns = new Column.CreateOptions[]
+				{
+					new Column.CreateOptions("id", Column.Type.Long),
+					new Column.CreateOptions("d", Column.Type.DoubleFloat),
+					new Column.CreateOptions("s", Column.Type.Text, Column.CodePage.Unicode),
+					new Column.CreateOptions("big", Column.Type.LongText, Column.CodePage.Unicode),
+					new Column.CreateOptions("empty", Column.Type.Long)
+				},
+				Indexes = new Index.CreateOptions[]
+				{
+					new Index.CreateOptions { Name = "PK", KeyColumns = "+id", Unique = true, Primary = true }
+				}
+			};
+		}
+
+		[Test]
+		public void RetrieveColumns()
+		{
+			string big = new string('x', 5000);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("RetrieveColumns"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 7);
+						u.Set(cols[1], Math.PI);
+						u.Set(cols[2], "short");
+						u.Set(cols[3], big);
+						u.Complete();
+					}
+
+					csr.MoveFirst();
+
+					var set = new ColumnSet(cols, new Type[] {typeof(int), typeof(double), typeof(string), typeof(string), typeof(int?)});
+					var vals = csr.RetrieveColumns(set);
+
+					Assert.That(vals.Length, Is.EqualTo(5));
+					Assert.That(vals[0], Is.EqualTo(7));
+					Assert.That(vals[1], Is.EqualTo(Math.PI));
+					Assert.That(vals[2], Is.EqualTo("short"));
+					Assert.That(vals[3], Is.EqualTo(big)); //larger than the presized buffer, refetched
+					Assert.That(vals[4], Is.Null);
+
+					var defaults = csr.RetrieveColumns(new ColumnSet(cols));
+
+					for(int i = 0; i < cols.Length; i++)
+						Assert.That(defaults[i], Is.EqualTo(csr.Retrieve<object>(cols[i])));
+				}
+			}
+		}
+
+		[Test]
+		public void RetrieveTyped()
+		{
+			var when = new DateTime(2009, 11, 5, 13, 30, 0);
+			var id = Guid.NewGuid();
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				var opts = WideTable("RetrieveTyped");
+				opts.Columns = new Column.CreateOptions[]
+				{
+					new Column.CreateOptions("id", Column.Type.Long),
+					new Column.CreateOptions("d", Column.Type.DoubleFloat),
+					new Column.CreateOptions("when", Column.Type.DateTime),
+					new Column.CreateOptions("guid", Column.Type.Binary),
+					new Column.CreateOptions("empty", Column.Type.Long),
+					new Column.CreateOptions { Name = "multi", Type = Column.Type.Long, Tagged = true, MultiValued = true }
+				};
+
+				using(var tab = Table.Create(E.D, opts, out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 42);
+						u.Set(cols[1], Math.E);
+						u.Set(cols[2], when);
+						u.Set(cols[3], id);
+
+						var so = new IWriteRecord.SetOptions { TagSequence = 0 };
+						for(int i = 1; i <= 3; i++)
+							u.Set(cols[5], i * 10, so);
+
+						u.Complete();
+					}
+
+					csr.MoveFirst();
+
+					bool isnull;
+
+					Assert.That(csr.RetrieveInt32(cols[0]), Is.EqualTo(42));
+					Assert.That(csr.RetrieveInt64(cols[0]), Is.EqualTo(42L));
+					Assert.That(csr.RetrieveDouble(cols[1]), Is.EqualTo(Math.E));
+					Assert.That(csr.RetrieveDateTime(cols[2]), Is.EqualTo(when));
+					Assert.That(csr.RetrieveGuid(cols[3]), Is.EqualTo(id));
+
+					Assert.That(csr.RetrieveInt32(cols[4], out isnull), Is.EqualTo(0));
+					Assert.That(isnull, Is.True);
+					Assert.That(csr.RetrieveInt32(cols[0], out isnull), Is.EqualTo(42));
+					Assert.That(isnull, Is.False);
+
+					Assert.That(csr.RetrieveAllValues<int>(cols[5]), Is.EqualTo(new int[] {10, 20, 30}));
+				}
+			}
+		}
+
+		[Test]
+		public void RetrieveGrowingValues()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("RetrieveGrowing"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					for(int i = 0; i < 4; i++)
+						using(var u = csr.BeginInsert())
+						{
+							u.Set(cols[0], i);
+							u.Set(cols[3], new string((char)('a' + i), 100 << (i * 4)));
+							u.Complete();
+						}
+
+					//values grow past the initial buffer, then shrink again; each must come back intact
+					for(int pass = 0; pass < 2; pass++)
+					{
+						bool has_current = csr.MoveFirst();
+
+						for(int i = 0; i < 4; i++)
+						{
+							Assert.That(has_current, Is.True);
+							Assert.That(csr.Retrieve<string>(cols[3]), Is.EqualTo(new string((char)('a' + i), 100 << (i * 4))));
+							Assert.That(csr.Retrieve<string>("big").Length, Is.EqualTo(100 << (i * 4)));
+
+							var limited = csr.Retrieve<string>(cols[3], new IReadRecord.RetrieveOptions { SizeLimit = 20 });
+							Assert.That(limited, Is.EqualTo(new string((char)('a' + i), 10)));
+
+							has_current = csr.Move(1);
+						}
+					}
+				}
+			}
+		}
+
+		[Test]
+		public void RetrieveAllFieldsCachedColumns()
+		{
+			if(!E.I.IsVersionAtLeast(5, 1))
+				Assert.Ignore("Requries 5.1+");
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("RetrieveAllFields"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 5);
+						u.Set(cols[2], "five");
+						u.Complete();
+					}
+
+					csr.MoveFirst();
+
+					var first = csr.RetrieveAllFields();
+					var second = csr.RetrieveAllFields();
+
+					Assert.That(first.Length, Is.EqualTo(2));
+					Assert.That(second.Length, Is.EqualTo(2));
+					Assert.That(second[0].Col, Is.SameAs(first[0].Col)); //same cached column map
+
+					var map = csr.ColumnMap;
+					var mapped = csr.RetrieveAllFields(0, map);
+
+					Assert.That(mapped[0].Val, Is.EqualTo(5));
+					Assert.That(mapped[1].Val, Is.EqualTo("five"));
+
+					//a column added through EseObjects appears in the cached map
+					var added = Column.Create(tab, new Column.CreateOptions("added", Column.Type.Long));
+
+					using(var u = csr.BeginReplace())
+					{
+						u.Set(added, 55);
+						u.Complete();
+					}
+
+					var after = csr.RetrieveAllFields();
+
+					Assert.That(after.Length, Is.EqualTo(3));
+					Assert.That(after[2].Col.Name, Is.EqualTo("added"));
+					Assert.That(after[2].Val, Is.EqualTo(55));
+
+					//but not in a map resolved beforehand
+					try
+					{
+						csr.RetrieveAllFields(0, map);
+						Assert.Fail("Exception expected");
+					}
+					catch(ArgumentException)
+					{}
+				}
+			}
+		}
+
+		[Test]
+		public void ReadBatch()
+		{
+			string big = new string('y', 3000);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("ReadBatch"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				using(var batch = new RowBatch())
+				{
+					for(int i = 0; i < 10; i++)
+						using(var u = csr.BeginInsert())
+						{
+							u.Set(cols[0], i);
+							u.Set(cols[2], "row" + i);
+							if(i == 4)
+								u.Set(cols[3], big);
+							u.Complete();
+						}
+
+					var set = new ColumnSet(new Column[] {cols[0], cols[2], cols[3]}, new Type[] {typeof(int), typeof(string), typeof(string)});
+					var seen = new List<int>();
+
+					csr.MoveFirst();
+
+					int ct;
+					while((ct = csr.ReadBatch(set, 3, batch)) > 0)
+					{
+						for(int r = 0; r < ct; r++)
+						{
+							int id = (int)batch[r, 0];
+
+							seen.Add(id);
+							Assert.That(batch[r, 1], Is.EqualTo("row" + id));
+							Assert.That(batch.IsNull(r, 2), Is.EqualTo(id != 4));
+							if(id == 4)
+								Assert.That(batch[r, 2], Is.EqualTo(big)); //larger than the presized buffer, refetched
+						}
+
+						if(batch.EndReached)
+							break;
+					}
+
+					Assert.That(seen.Count, Is.EqualTo(10));
+					Assert.That(batch.EndReached);
+					for(int i = 0; i < seen.Count; i++)
+						Assert.That(seen[i], Is.EqualTo(i));
+
+					//only rows in the range are read
+					Field[] lower = new Field[] {new Field(cols[0], 3)};
+					Field[] upper = new Field[] {new Field(cols[0], 6)};
+					Assert.That(csr.ForwardRangeInclusive(lower, upper));
+					Assert.That(csr.ReadBatch(set, 100, batch), Is.EqualTo(4));
+					Assert.That(batch.EndReached);
+					Assert.That(batch.GetRow(3)[0], Is.EqualTo(6));
+
+					//a large limit only costs the rows read
+					csr.MoveFirst();
+					Assert.That(csr.ReadBatch(set, int.MaxValue, batch), Is.EqualTo(10));
+					Assert.That(batch.EndReached);
+					Assert.That(batch.GetRow(9)[0], Is.EqualTo(9));
+					Assert.That(batch[4, 2], Is.EqualTo(big));
+
+					//but one whose value count doesn't fit in 32 bits is refused
+					csr.MoveFirst();
+					try
+					{
+						csr.ReadBatch(set, 0x55555556, batch);
+						Assert.Fail("Exception expected");
+					}
+					catch(ArgumentOutOfRangeException)
+					{}
+				}
+			}
+		}
+
+		[Test]
+		public void ReadRecordBatch()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("ReadRecordBatch"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				using(var batch = new RecordBatch())
+				{
+					for(int i = 0; i < 5; i++)
+						using(var u = csr.BeginInsert())
+						{
+							u.Set(cols[0], i);
+							u.Set(cols[1], i * 0.5);
+							if(i != 2)
+								u.Set(cols[2], new string('a', i));
+							u.Complete();
+						}
+
+					csr.MoveFirst();
+
+					Assert.That(csr.ReadRecordBatch(new ColumnSet(cols), 10, batch), Is.EqualTo(5));
+					Assert.That(batch.EndReached);
+
+					Assert.That(batch.ElementTypeOf(0), Is.EqualTo(typeof(int)));
+					Assert.That(batch.ElementTypeOf(2), Is.EqualTo(typeof(char)));
+
+					int[] ids = batch.GetValues<int>(0);
+					double[] ds = batch.GetValues<double>(1);
+					int[] offsets = batch.GetOffsets(2);
+
+					Assert.That(batch.GetOffsets(0), Is.Null);
+
+					for(int r = 0; r < 5; r++)
+					{
+						Assert.That(ids[r], Is.EqualTo(r));
+						Assert.That(ds[r], Is.EqualTo(r * 0.5));
+						Assert.That(batch.IsNull(r, 2), Is.EqualTo(r == 2));
+						Assert.That(batch.GetString(r, 2), Is.EqualTo(r == 2 ? null : new string('a', r)));
+						Assert.That(offsets[r + 1] - offsets[r], Is.EqualTo(r == 2 ? 0 : r));
+						Assert.That(batch.IsNull(r, 4));
+					}
+
+					Assert.That(batch.GetNullBitmap(4)[0], Is.EqualTo(0x1F));
+					Assert.That(batch.GetNullBitmap(0)[0], Is.EqualTo(0));
+				}
+			}
+		}
+
+		[Test]
+		public void SetColumns()
+		{
+			string big = new string('z', 4000);
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("SetColumns"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					using(var u = csr.BeginInsert())
+					{
+						u.SetColumns(cols, new object[] {3, 1.5, "", big, null});
+						u.Complete();
+					}
+
+					csr.MoveFirst();
+
+					var vals = csr.RetrieveColumns(new ColumnSet(cols));
+
+					Assert.That(vals[0], Is.EqualTo(3));
+					Assert.That(vals[1], Is.EqualTo(1.5));
+					Assert.That(vals[2], Is.EqualTo(""));
+					Assert.That(vals[3], Is.EqualTo(big));
+					Assert.That(vals[4], Is.Null);
+
+					using(var u = csr.BeginReplace())
+					{
+						u.SetColumns(new Column[] {cols[4]}, new object[] {9});
+						u.Complete();
+					}
+
+					Assert.That(csr.Retrieve<int>(cols[4]), Is.EqualTo(9));
+				}
+			}
+		}
+
+		class UpperBridge : Bridge
+		{
+			public override object ValueBytesToObject(Type type, bool isnull, IntPtr bytes, uint size, Column.Type coltyp, ushort cp)
+			{
+				object o = base.ValueBytesToObject(type, isnull, bytes, size, coltyp, cp);
+				string s = o as string;
+
+				return s != null ? s.ToUpperInvariant() : o;
+			}
+		}
+
+		[Test]
+		public void ConversionCache()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("ConversionCache"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 7);
+						u.Set(cols[2], "abc");
+						u.Complete();
+					}
+
+					csr.MoveFirst();
+
+					//alternating requested types on one column replaces the cached conversion each time
+					for(int i = 0; i < 3; i++)
+					{
+						Assert.That(csr.Retrieve<object>(cols[0]), Is.EqualTo(7));
+						Assert.That(csr.Retrieve<long>(cols[0]), Is.EqualTo(7L));
+						Assert.That(csr.Retrieve<string>(cols[2]), Is.EqualTo("abc"));
+					}
+
+					//a custom Bridge is still used after the default one has cached conversions
+					csr.Bridge = new UpperBridge();
+					Assert.That(csr.Retrieve<string>(cols[2]), Is.EqualTo("ABC"));
+
+					using(var u = csr.BeginReplace())
+					{
+						u.Set(cols[2], "def");
+						u.Complete();
+					}
+
+					Assert.That(csr.Retrieve<string>(cols[2]), Is.EqualTo("DEF"));
+				}
+			}
+		}
+
+		class PlainBridge : Bridge
+		{
+		}
+
+		//only overrides writing, so reads still take the builtin path
+		class ReverseWriteBridge : Bridge
+		{
+			public override byte[] ValueBytesFromObject(object o, ref bool isnull, Column.Type coltyp, ushort cp)
+			{
+				string s = o as string;
+
+				if(s == null)
+					return null;
+
+				char[] chars = s.ToCharArray();
+				Array.Reverse(chars);
+				return System.Text.Encoding.Unicode.GetBytes(chars);
+			}
+		}
+
+		[Test]
+		public void BridgeHooks()
+		{
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				using(var tab = Table.Create(E.D, WideTable("BridgeHooks"), out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					csr.Bridge = new PlainBridge();
+
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 1);
+						u.Set(cols[2], "abc");
+						u.CompleteSeek();
+					}
+
+					Assert.That(csr.Retrieve<int>(cols[0]), Is.EqualTo(1));
+					Assert.That(csr.Retrieve<string>(cols[2]), Is.EqualTo("abc"));
+
+					csr.Bridge = new ReverseWriteBridge();
+
+					using(var u = csr.BeginReplace())
+					{
+						u.Set(cols[2], "xyz");
+						u.Set(cols[4], 5);
+						u.Complete();
+					}
+
+					Assert.That(csr.Retrieve<string>(cols[2]), Is.EqualTo("zyx"));
+					Assert.That(csr.Retrieve<int>(cols[4]), Is.EqualTo(5));
+				}
+			}
+		}
+
+		[Test]
+		public void TextRoundTrip()
+		{
+			//lengths either side of the 16 character transcoding step and the pinning threshold
+			string[] ascii = {"", "abc", new string('a', 16), "0123456789abcdefXYZ", new string('q', 300)};
+			string[] wide = {"", "\u00e9t\u00e9", new string('\u4e2d', 200)};
+
+			using(var tr = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+
+				var opts = new Table.CreateOptions
+				{
+					Name = "TextRoundTrip",
+					Columns = new Column.CreateOptions[]
+					{
+						new Column.CreateOptions("id", Column.Type.Long),
+						new Column.CreateOptions("a", Column.Type.LongText, Column.CodePage.English),
+						new Column.CreateOptions("w", Column.Type.LongText, Column.CodePage.Unicode)
+					},
+					Indexes = new Index.CreateOptions[]
+					{
+						new Index.CreateOptions { Name = "PK", KeyColumns = "+id", Unique = true, Primary = true }
+					}
+				};
+
+				using(var tab = Table.Create(E.D, opts, out cols, out ixs))
+				using(var csr = new Cursor(tab))
+				{
+					for(int i = 0; i < ascii.Length; i++)
+					{
+						using(var u = csr.BeginInsert())
+						{
+							u.Set(cols[0], i);
+							u.Set(cols[1], ascii[i]);
+							u.Set(cols[2], wide[i % wide.Length]);
+							u.Complete();
+						}
+					}
+
+					for(int i = 0; i < ascii.Length; i++)
+					{
+						Assert.That(csr.Seek(cols[0], i));
+
+						Assert.That(csr.Retrieve<string>(cols[1]), Is.EqualTo(ascii[i]));
+						Assert.That(csr.Retrieve<string>(cols[2]), Is.EqualTo(wide[i % wide.Length]));
+					}
+
+					//text outside ASCII in a cp 1252 column still reads back with substitutes
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 100);
+						u.Set(cols[1], "caf\u00e9");
+						u.Complete();
+					}
+
+					Assert.That(csr.Seek(cols[0], 100));
+					Assert.That(csr.Retrieve<string>(cols[1]), Is.EqualTo("caf?"));
+				}
+			}
+		}
+	}
+}
@@ -104,6 +104,47 @@ namespace Test.DatabaseTests
 		public XYZ xyz;
 	}
 
+	enum Parity
+	{
+		None,
+		Odd,
+		Even
+	}
+
+	[Serializable]
+	class LineSettings
+	{
+		public string Port;
+		public Parity Parity;
+		public int? StopBits;
+		public int[] Rates;
+		public byte[] Init;
+		public XYZ Origin;
+		public LineSettings Fallback;
+	}
+
+	[Serializable]
+	class ModemSettings : LineSettings
+	{
+		public string Dial;
+	}
+
+	[Serializable]
+	class BadNode
+	{
+		public BadNode[] Children;
+		public object Tag; //can't be stored without type names
+	}
+
+	class SerializedMembers
+	{
+		public int K;
+		[BinaryFieldSerialization]
+		public int? Count;
+		[BinaryFieldSerialization]
+		public LineSettings Settings;
+	}
+
 	[TestFixture]
 	class SerializationTest
 	{
@@ -153,6 +194,199 @@ namespace Test.DatabaseTests
 			}
 		}
 
+		static byte[] SerializedBytes(IValueSerializer ser, object value)
+		{
+			var stream = new System.IO.MemoryStream();
+			ser.Serialize(value.GetType(), value, stream);
+			return stream.ToArray();
+		}
+
+		[Test]
+		public void CompactSerial()
+		{
+			var a = new LineSettings
+			{
+				Port = "COM1",
+				Parity = Parity.Even,
+				StopBits = null,
+				Rates = new int[] {300, 1200, 9600},
+				Init = new byte[] {0x1b, 0x40},
+				Origin = new XYZ {x = 33, y = "RS232 - 9600 baud", z = Math.E},
+				Fallback = new LineSettings {Port = "COM2", StopBits = 2}
+			};
+
+			var compact = new CompactSerializer();
+
+			Assert.Less(SerializedBytes(compact, a).Length, SerializedBytes(new BinaryFormatterSerializer(), a).Length);
+
+			using(var trans_mod = new Transaction(E.S))
+			{
+				Column[] cols;
+				Index[] ixs;
+				var CompactSerial = Table.Create(E.D, new Table.CreateOptions
+				{
+					Name = "CompactSerial",
+					Columns = new Column.CreateOptions[]
+					{
+						new Column.CreateOptions("K", Column.Type.Long),
+						new Column.CreateOptions("Data", Column.Type.LongBinary)
+					},
+					Indexes = new Index.CreateOptions[]
+					{
+						new Index.CreateOptions { Name = "PK", KeyColumns = "+K", Unique = true, Primary = true }
+					}
+				}, out cols, out ixs);
+
+				using(var csr = new Cursor(CompactSerial))
+				{
+					csr.Bridge = new Bridge { Serializer = compact };
+
+					using(var u = csr.BeginInsert())
+					{
+						u.Set(cols[0], 0);
+						u.Set(cols[1], a);
+						u.Complete();
+					}
+
+					Assert.IsTrue(csr.Seek(cols[0], 0));
+
+					var b = csr.Retrieve<LineSettings>(cols[1]);
+
+					Assert.AreEqual(a.Port, b.Port);
+					Assert.AreEqual(a.Parity, b.Parity);
+					Assert.IsNull(b.StopBits);
+					Assert.AreEqual(a.Rates, b.Rates);
+					Assert.AreEqual(a.Init, b.Init);
+					Assert.AreEqual(a.Origin.x, b.Origin.x);
+					Assert.AreEqual(a.Origin.y, b.Origin.y);
+					Assert.AreEqual(a.Origin.z, b.Origin.z);
+					Assert.AreEqual("COM2", b.Fallback.Port);
+					Assert.AreEqual(2, b.Fallback.StopBits);
+					Assert.IsNull(b.Fallback.Fallback);
+					Assert.IsNull(b.Fallback.Rates);
+
+					//the stored bytes are exactly what the serializer produces on its own
+					Assert.AreEqual(SerializedBytes(compact, a), csr.Retrieve<byte[]>(cols[1]));
+				}
+
+				trans_mod.Rollback();
+			}
+		}
+
+		[Test]
+		public void CompactSerialDeclaredTypes()
+		{
+			var compact = new CompactSerializer();
+
+			using(var trans_mod = new Transaction(E.S))
+			{
+				var table = Table.Create(E.D, new Table.CreateOptions
+				{
+					Name = "CompactDeclared",
+					Columns = new Column.CreateOptions[]
+					{
+						new Column.CreateOptions("K", Column.Type.Long),
+						new Column.CreateOptions("Count", Column.Type.LongBinary),
+						new Column.CreateOptions("Settings", Column.Type.LongBinary)
+					},
+					Indexes = new Index.CreateOptions[]
+					{
+						new Index.CreateOptions { Name = "PK", KeyColumns = "+K", Unique = true, Primary = true }
+					}
+				});
+
+				using(var csr = new Cursor(table))
+				{
+					var flat = new Flat<SerializedMembers>(table, compact);
+
+					//int? is written and read with the nullable format, null members as null columns
+					using(var u = csr.BeginInsert())
+					{
+						flat.Write(u, new SerializedMembers {K = 1, Count = 7, Settings = new LineSettings {Port = "COM1"}});
+						u.Complete();
+					}
+
+					using(var u = csr.BeginInsert())
+					{
+						flat.Write(u, new SerializedMembers {K = 2, Count = null, Settings = null});
+						u.Complete();
+					}
+
+					Assert.IsTrue(csr.Seek(new Column(table, "K"), 1));
+					var a = flat.Read(csr);
+					Assert.AreEqual(7, a.Count);
+					Assert.AreEqual("COM1", a.Settings.Port);
+
+					Assert.IsTrue(csr.Seek(new Column(table, "K"), 2));
+					var b = flat.Read(csr);
+					Assert.IsNull(b.Count);
+					Assert.IsNull(b.Settings);
+					Assert.IsNull(csr.Retrieve<byte[]>(new Column(table, "Settings")));
+
+					//a derived instance can't be read back as the declared base type, so it's rejected when written
+					using(var u = csr.BeginInsert())
+					{
+						try
+						{
+							flat.Write(u, new SerializedMembers {K = 3, Settings = new ModemSettings {Port = "COM3", Dial = "ATDT"}});
+							Assert.Fail("Exception expected");
+						}
+						catch(System.Runtime.Serialization.SerializationException)
+						{}
+					}
+				}
+
+				trans_mod.Rollback();
+			}
+		}
+
+		[Test]
+		public void CompactSerialFailedBuild()
+		{
+			var compact = new CompactSerializer();
+
+			//BadNode[] is cached while BadNode is built, pointing at the BadNode codec that then fails
+			for(int i = 0; i < 2; i++)
+			{
+				try
+				{
+					SerializedBytes(compact, new BadNode());
+					Assert.Fail("Exception expected");
+				}
+				catch(NotSupportedException)
+				{}
+
+				try
+				{
+					SerializedBytes(compact, new BadNode[] {new BadNode()});
+					Assert.Fail("Exception expected");
+				}
+				catch(NotSupportedException)
+				{}
+			}
+		}
+
+		[Test]
+		public void CompactSerialLeftoverBytes()
+		{
+			var compact = new CompactSerializer();
+			var bytes = SerializedBytes(compact, new ModemSettings {Port = "COM3", Dial = "ATDT"});
+
+			//read back as its own type every byte is used
+			var m = (ModemSettings)compact.Deserialize(typeof(ModemSettings), new System.IO.MemoryStream(bytes));
+			Assert.AreEqual("COM3", m.Port);
+			Assert.AreEqual("ATDT", m.Dial);
+
+			//read as the base type the derived fields are left over, which fails rather than returning a partial value
+			try
+			{
+				compact.Deserialize(typeof(LineSettings), new System.IO.MemoryStream(bytes));
+				Assert.Fail("Exception expected");
+			}
+			catch(System.Runtime.Serialization.SerializationException)
+			{}
+		}
+
 		[Test]
 		public void FieldBinSerial()
 		{
@@ -254,6 +488,21 @@ namespace Test.DatabaseTests
 					csr.MoveFirst();
 					d2 = srr.Read(csr);
 
+					//same layout with the compact serializer for BinaryFieldSerialization members
+					var compact = new Flat<DEF>(table, new CompactSerializer());
+					DEF d3 = d1;
+					d3.d = 6;
+					using(var u = csr.BeginInsert())
+					{
+						compact.Write(u, d3);
+						u.Complete();
+					}
+
+					csr.MoveLast();
+					Assert.AreEqual(d3.d, compact.Read(csr).d);
+					Assert.AreEqual(d3.f, compact.Read(csr).f);
+					csr.MoveFirst();
+
 					Field[] values = csr.RetrieveAllFields();
 
 					Assert.AreEqual(d1.d, d2.d);